@@ -0,0 +1,110 @@
+/**
+bfloat16 storage type and its vector conversions, shared by the modules that
+store samples as 16-bit floats (conv1d, hilbert)
+ */
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace bf16 {
+
+/**
+bfloat16: the top 16 bits of an IEEE fp32 (named to avoid the bfloat16
+typedef in OpenBLAS cblas.h).
+Conversion from float rounds to nearest even and keeps NaNs quiet.
+*/
+struct BFloat16 {
+  uint16_t bits;
+
+  BFloat16() = default;
+  explicit BFloat16(float f) : bits(from_float(f)) {}
+
+  operator float() const { // NOLINT(*-explicit-*)
+    return std::bit_cast<float>(static_cast<uint32_t>(bits) << 16);
+  }
+
+  static constexpr auto from_float(float f) -> uint16_t {
+    const auto u = std::bit_cast<uint32_t>(f);
+    if ((u & 0x7fffffffU) > 0x7f800000U) {
+      return static_cast<uint16_t>((u >> 16) | 0x40U); // quiet NaN
+    }
+    return static_cast<uint16_t>((u + 0x7fffU + ((u >> 16) & 1U)) >> 16);
+  }
+};
+
+/*
+Vector loads and stores of 8 (AVX2) or 16 (AVX-512) values as fp32,
+rounding like BFloat16::from_float. The AVX-512-BF16 instructions, where
+available, also flush fp32 denormals to zero.
+*/
+// NOLINTBEGIN(*-magic-numbers)
+
+#if defined(__AVX2__)
+
+inline auto load8(const BFloat16 *p) -> __m256 {
+  const __m256i u = _mm256_cvtepu16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(u, 16));
+}
+
+inline void store8(BFloat16 *p, __m256 v) {
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+  const __m128bh h = _mm256_cvtneps_pbh(v);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(p),
+                   reinterpret_cast<const __m128i &>(h));
+#else
+  const __m256i u = _mm256_castps_si256(v);
+  const __m256i lsb =
+      _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1));
+  __m256i r =
+      _mm256_add_epi32(u, _mm256_add_epi32(_mm256_set1_epi32(0x7fff), lsb));
+  const __m256i nan = _mm256_or_si256(u, _mm256_set1_epi32(0x400000));
+  const __m256 is_nan = _mm256_cmp_ps(v, v, _CMP_UNORD_Q);
+  r = _mm256_blendv_epi8(r, nan, _mm256_castps_si256(is_nan));
+  r = _mm256_srli_epi32(r, 16);
+  // packus works per 128-bit lane; gather the two low halves
+  const __m256i packed =
+      _mm256_permute4x64_epi64(_mm256_packus_epi32(r, r), 0b1000);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(p),
+                   _mm256_castsi256_si128(packed));
+#endif
+}
+
+#endif
+
+#if defined(__AVX512F__)
+
+inline auto load16(const BFloat16 *p) -> __m512 {
+  const __m512i u = _mm512_cvtepu16_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(u, 16));
+}
+
+inline void store16(BFloat16 *p, __m512 v) {
+#if defined(__AVX512BF16__)
+  const __m256bh h = _mm512_cvtneps_pbh(v);
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(p),
+                      reinterpret_cast<const __m256i &>(h));
+#else
+  const __m512i u = _mm512_castps_si512(v);
+  const __m512i lsb =
+      _mm512_and_si512(_mm512_srli_epi32(u, 16), _mm512_set1_epi32(1));
+  __m512i r =
+      _mm512_add_epi32(u, _mm512_add_epi32(_mm512_set1_epi32(0x7fff), lsb));
+  const __mmask16 is_nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+  r = _mm512_mask_or_epi32(r, is_nan, u, _mm512_set1_epi32(0x400000));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(p),
+                      _mm512_cvtepi32_epi16(_mm512_srli_epi32(r, 16)));
+#endif
+}
+
+#endif
+
+// NOLINTEND(*-magic-numbers)
+
+} // namespace bf16
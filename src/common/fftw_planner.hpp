@@ -0,0 +1,22 @@
+/**
+The FFTW planner lock, shared by the FFTW wrappers in this tree (hilbert's
+fftw.hpp and conv1d's conv1d_fftw.hpp)
+ */
+#pragma once
+
+#include <mutex>
+
+namespace fftw_planner {
+
+/*
+Guards the FFTW planner (plan creation and destruction, wisdom import and
+export), which unlike fftw_execute is not thread safe. The planner state is
+process-wide, so there is one lock for every wrapper: a lock per wrapper
+would let two of them plan at the same time.
+*/
+inline auto mutex() -> std::mutex & {
+  static std::mutex mtx;
+  return mtx;
+}
+
+} // namespace fftw_planner
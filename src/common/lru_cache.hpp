@@ -0,0 +1,115 @@
+/**
+A bounded cache of objects built from their key, evicting the least recently
+used entry once it holds more than `max_entries` entries or `max_bytes`
+resident bytes.
+
+Resident bytes of a value (resident_bytes_of) are sizeof(Val) plus
+val.bytes() when Val has it (e.g. the FFTW engines count their buffers).
+Limits and counters live outside the cache so several caches (e.g. one per
+thread) can share them.
+ */
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+struct CacheLimits {
+  std::atomic<size_t> max_entries{std::numeric_limits<size_t>::max()};
+  std::atomic<size_t> max_bytes{std::numeric_limits<size_t>::max()};
+};
+
+struct CacheCounters {
+  std::atomic<size_t> hits{};
+  std::atomic<size_t> misses{};
+  std::atomic<size_t> evictions{};
+  std::atomic<size_t> resident_bytes{};
+};
+
+template <class Val> auto resident_bytes_of(const Val &val) -> size_t {
+  if constexpr (requires {
+                  { val.bytes() } -> std::convertible_to<size_t>;
+                }) {
+    return sizeof(Val) + val.bytes();
+  } else {
+    return sizeof(Val);
+  }
+}
+
+template <class Key, class Val, class Hash = std::hash<Key>> class LruCache {
+public:
+  LruCache(const CacheLimits &limits, CacheCounters &counters)
+      : limits(limits), counters(counters) {}
+  LruCache(const LruCache &) = delete;
+  LruCache(LruCache &&) = delete;
+  LruCache &operator=(const LruCache &) = delete;
+  LruCache &operator=(LruCache &&) = delete;
+  ~LruCache() { clear(); }
+
+  /**
+  The value for `key`, built as Val(key) on a miss. The returned reference
+  stays valid until the entry is evicted: the entry returned last is never
+  evicted, older ones can be by any later miss.
+  */
+  auto get(const Key &key) -> Val & {
+    if (auto it = index.find(key); it != index.end()) {
+      ++counters.hits;
+      order.splice(order.begin(), order, it->second);
+      return *it->second->val;
+    }
+
+    ++counters.misses;
+    auto val = std::make_unique<Val>(key);
+    const size_t val_bytes = resident_bytes_of(*val);
+    order.push_front(Entry{key, std::move(val), val_bytes});
+    index.emplace(key, order.begin());
+    bytes += val_bytes;
+    counters.resident_bytes += val_bytes;
+
+    evict();
+    return *order.front().val;
+  }
+
+  // Evict down to the limits, keeping the most recent entry
+  void evict() {
+    while (order.size() > 1 && (order.size() > limits.max_entries.load() ||
+                                bytes > limits.max_bytes.load())) {
+      pop_back();
+      ++counters.evictions;
+    }
+  }
+
+  void clear() {
+    while (!order.empty()) { pop_back(); }
+  }
+
+  [[nodiscard]] auto size() const -> size_t { return order.size(); }
+  [[nodiscard]] auto resident_bytes() const -> size_t { return bytes; }
+
+private:
+  struct Entry {
+    Key key;
+    std::unique_ptr<Val> val;
+    size_t bytes;
+  };
+
+  const CacheLimits &limits;
+  CacheCounters &counters;
+  // Most recently used first
+  std::list<Entry> order;
+  std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+  size_t bytes{};
+
+  void pop_back() {
+    Entry &entry = order.back();
+    bytes -= entry.bytes;
+    counters.resident_bytes -= entry.bytes;
+    index.erase(entry.key);
+    order.pop_back();
+  }
+};
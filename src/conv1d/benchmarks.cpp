@@ -1,8 +1,20 @@
 #include "conv1d.hpp"
+#include "conv1d_auto.hpp"
+#include "conv1d_batch.hpp"
+#include "conv1d_complex.hpp"
+#include "conv1d_fft.hpp"
+#include "conv1d_half.hpp"
+#include "conv1d_int16.hpp"
+#include "conv1d_parallel.hpp"
+#include "conv1d_partitioned.hpp"
+#include "conv1d_polyphase.hpp"
+#include "conv1d_stream.hpp"
 #include <armadillo>
 #include <benchmark/benchmark.h>
 #include <fftconv.hpp>
 #include <fftw.hpp>
+#include <opencv2/opencv.hpp>
+#include <random>
 #include <vector>
 
 #define RUN_ALL
@@ -71,6 +83,17 @@ void conv_bench_valid(benchmark::State &state, Func conv_func) {
   }
 }
 
+template <typename T, ConvMode Mode, typename Func>
+void conv_bench(benchmark::State &state, Func conv_func) {
+  if constexpr (Mode == ConvMode::Full) {
+    conv_bench_full<T>(state, conv_func);
+  } else if constexpr (Mode == ConvMode::Same) {
+    conv_bench_same<T>(state, conv_func);
+  } else if constexpr (Mode == ConvMode::Valid) {
+    conv_bench_valid<T>(state, conv_func);
+  }
+}
+
 #ifdef RUN_ALL
 
 /*
@@ -83,8 +106,37 @@ BENCHMARK(BM_conv1d_naive<double>)->ArgsProduct(ARGS);
 
 /*
 Conv1d with BLAS
+(input size, kernel size, filter bank width)
+Bank width 1 runs GEMV, wider banks a single GEMM over the shared im2col
 */
-template <typename T> static void BM_conv1d_BLAS(benchmark::State &state) {
+const std::vector<std::vector<int64_t>> BLAS_ARGS{
+    ARGS[0],
+    ARGS[1],
+    {1, 8, 32},
+};
+
+template <typename T, ConvMode Mode>
+static void BM_conv1d_BLAS(benchmark::State &state) {
+  const auto n_kernels = static_cast<size_t>(state.range(2));
+  arma::Col<T> input(state.range(0), arma::fill::randn);
+  arma::Col<T> kernels(state.range(1) * n_kernels, arma::fill::randn);
+  arma::Col<T> output(
+      conv1d_output_size<Mode>(input.size(), state.range(1)) * n_kernels);
+
+  Conv1dBLASWorkspace<T> workspace;
+  workspace.template conv_bank<Mode>(input, kernels, n_kernels, output);
+  for (auto _ : state) {
+    workspace.template conv_bank<Mode>(input, kernels, n_kernels, output);
+  }
+  state.SetItemsProcessed(state.iterations() * input.size() * n_kernels);
+}
+BENCHMARK(BM_conv1d_BLAS<double, ConvMode::Full>)->ArgsProduct(BLAS_ARGS);
+BENCHMARK(BM_conv1d_BLAS<double, ConvMode::Same>)->ArgsProduct(BLAS_ARGS);
+BENCHMARK(BM_conv1d_BLAS<double, ConvMode::Valid>)->ArgsProduct(BLAS_ARGS);
+
+// Free function with a caller owned im2col buffer ("valid" only)
+template <typename T>
+static void BM_conv1d_BLAS_im2col(benchmark::State &state) {
   arma::Col<T> input(state.range(0), arma::fill::randn);
   arma::Col<T> kernel(state.range(1), arma::fill::randn);
   arma::Col<T> output(input.size() - kernel.size() + 1);
@@ -95,7 +147,7 @@ template <typename T> static void BM_conv1d_BLAS(benchmark::State &state) {
     conv1d_BLAS_im2col<T>(input, kernel, im2col, output);
   }
 }
-BENCHMARK(BM_conv1d_BLAS<double>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_BLAS_im2col<double>)->ArgsProduct(ARGS);
 
 // Wrapper to prevent arma::conv from being optimized away
 // Not storing results back in res.
@@ -136,12 +188,292 @@ void BM_conv1d_OpenCV(benchmark::State &state) {
 }
 BENCHMARK(BM_conv1d_OpenCV<double>)->ArgsProduct(ARGS);
 
+/*
+Linear-phase direct convolution (mirrored input samples pre-added)
+*/
+template <fftconv::FloatOrDouble Real, ConvMode Mode, KernelSymmetry Symmetry>
+void BM_conv1d_linear_phase(benchmark::State &state) {
+  arma::Col<Real> input(state.range(0), arma::fill::randn);
+  arma::Col<Real> kernel(state.range(1), arma::fill::randn);
+  const auto k = kernel.size();
+  for (size_t j = 0; j < k / 2; ++j) {
+    kernel[k - 1 - j] =
+        Symmetry == KernelSymmetry::Symmetric ? kernel[j] : -kernel[j];
+  }
+  if (Symmetry == KernelSymmetry::Antisymmetric && k % 2 == 1) {
+    kernel[k / 2] = 0;
+  }
+  arma::Col<Real> output(conv1d_output_size<Mode>(input.size(), k));
+
+  const auto run = [&] {
+    conv1d_linear_phase<Real, Mode>(input, kernel, output, Symmetry);
+  };
+  run();
+  for (auto _ : state) {
+    run();
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_conv1d_linear_phase<double, ConvMode::Valid,
+                                 KernelSymmetry::Symmetric>)
+    ->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_linear_phase<double, ConvMode::Full,
+                                 KernelSymmetry::Symmetric>)
+    ->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_linear_phase<double, ConvMode::Full,
+                                 KernelSymmetry::Antisymmetric>)
+    ->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_linear_phase<float, ConvMode::Full,
+                                 KernelSymmetry::Symmetric>)
+    ->ArgsProduct(ARGS);
+
+/*
+int16 ADC samples: int16 x int16 -> int32 direct convolution, against
+converting to double and running Eigen (same as BM_conv1d_Eigen). Both run
+in valid mode.
+*/
+inline auto random_int16(size_t n) -> std::vector<int16_t> {
+  std::mt19937 gen(n);
+  std::uniform_int_distribution<int> dist(-32768, 32767);
+  std::vector<int16_t> v(n);
+  for (auto &x : v) { x = static_cast<int16_t>(dist(gen)); }
+  return v;
+}
+
+void BM_conv1d_int16(benchmark::State &state) {
+  const auto input = random_int16(state.range(0));
+  const arma::Col<double> kernel(state.range(1), arma::fill::randn);
+  const auto q = quantize_kernel<double>(kernel);
+  std::vector<int32_t> output(input.size() - kernel.size() + 1);
+
+  conv1d_int16<ConvMode::Valid>(input, q.taps, output);
+  for (auto _ : state) {
+    conv1d_int16<ConvMode::Valid>(input, q.taps, output);
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_conv1d_int16)->ArgsProduct(ARGS);
+
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_int16_via_float(benchmark::State &state) {
+  const auto input = random_int16(state.range(0));
+  const arma::Col<Real> kernel(state.range(1), arma::fill::randn);
+  arma::Col<Real> converted(input.size());
+  arma::Col<Real> output(input.size() - kernel.size() + 1);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < input.size(); ++i) {
+      converted[i] = static_cast<Real>(input[i]);
+    }
+    conv1d_eigen<Real>(converted, kernel, output);
+    benchmark::DoNotOptimize(output.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_conv1d_int16_via_float<double>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_int16_via_float<float>)->ArgsProduct(ARGS);
+
+/*
+16-bit storage with fp32 accumulation against the fp32 SIMD kernel.
+Bytes processed counts the input and output streams.
+*/
+template <typename S> void BM_conv1d_storage(benchmark::State &state) {
+  const arma::Col<float> src(state.range(0), arma::fill::randn);
+  const arma::Col<float> kernel(state.range(1), arma::fill::randn);
+  std::vector<S> input(src.size());
+  for (size_t i = 0; i < src.size(); ++i) { input[i] = S(src[i]); }
+  std::vector<S> output(input.size() + kernel.size() - 1);
+
+  const auto run = [&] {
+    if constexpr (std::is_same_v<S, float>) {
+      conv1d_simd<float, ConvMode::Full>(input, kernel, output);
+    } else {
+      conv1d_simd_storage<S, ConvMode::Full>(input, kernel, output);
+    }
+  };
+  run();
+  for (auto _ : state) {
+    run();
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+  state.SetBytesProcessed(state.iterations() *
+                          (input.size() + output.size()) * sizeof(S));
+}
+BENCHMARK(BM_conv1d_storage<float>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_storage<bf16::BFloat16>)->ArgsProduct(ARGS);
+#if defined(__FLT16_MAX__)
+BENCHMARK(BM_conv1d_storage<_Float16>)->ArgsProduct(ARGS);
+#endif
+
+/*
+Complex signals (full mode): interleaved std::complex vs split re/im arrays,
+with complex and real kernels. The FFT path runs on longer kernels.
+*/
+enum class CxLayout { Interleaved, Split };
+
+template <fftconv::FloatOrDouble Real>
+auto random_complex(size_t n) -> std::vector<std::complex<Real>> {
+  std::mt19937 gen(n);
+  std::normal_distribution<Real> dist;
+  std::vector<std::complex<Real>> v(n);
+  for (auto &x : v) { x = {dist(gen), dist(gen)}; }
+  return v;
+}
+
+template <fftconv::FloatOrDouble Real, CxLayout Layout, bool RealKernel,
+          typename Func>
+void conv_bench_complex(benchmark::State &state, Func conv_func) {
+  const auto input = random_complex<Real>(state.range(0));
+  const auto kernel = random_complex<Real>(state.range(1));
+  const size_t n = input.size();
+  const size_t k = kernel.size();
+  const size_t n_out = n + k - 1;
+
+  std::vector<Real> kernel_re(k);
+  std::vector<Real> kernel_im(k);
+  for (size_t j = 0; j < k; ++j) {
+    kernel_re[j] = kernel[j].real();
+    kernel_im[j] = kernel[j].imag();
+  }
+
+  if constexpr (Layout == CxLayout::Interleaved) {
+    std::vector<std::complex<Real>> output(n_out);
+    const auto run = [&] {
+      if constexpr (RealKernel) {
+        conv_func(std::span<const std::complex<Real>>(input),
+                  std::span<const Real>(kernel_re), output);
+      } else {
+        conv_func(std::span<const std::complex<Real>>(input),
+                  std::span<const std::complex<Real>>(kernel), output);
+      }
+    };
+    run();
+    for (auto _ : state) {
+      run();
+    }
+  } else {
+    std::vector<Real> in_re(n);
+    std::vector<Real> in_im(n);
+    for (size_t i = 0; i < n; ++i) {
+      in_re[i] = input[i].real();
+      in_im[i] = input[i].imag();
+    }
+    std::vector<Real> out_re(n_out);
+    std::vector<Real> out_im(n_out);
+    const SplitComplex<const Real> in{in_re.data(), in_im.data(), n};
+    const SplitComplex<Real> out{out_re.data(), out_im.data(), n_out};
+    const auto run = [&] {
+      if constexpr (RealKernel) {
+        conv_func(in, std::span<const Real>(kernel_re), out);
+      } else {
+        conv_func(in,
+                  SplitComplex<const Real>{kernel_re.data(), kernel_im.data(),
+                                           k},
+                  out);
+      }
+    };
+    run();
+    for (auto _ : state) {
+      run();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <fftconv::FloatOrDouble Real, CxLayout Layout, bool RealKernel>
+void BM_conv1d_complex(benchmark::State &state) {
+  conv_bench_complex<Real, Layout, RealKernel>(state, [](auto &&...args) {
+    conv1d_complex<Real, ConvMode::Full>(args...);
+  });
+}
+BENCHMARK(BM_conv1d_complex<double, CxLayout::Interleaved, false>)
+    ->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_complex<double, CxLayout::Split, false>)
+    ->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_complex<double, CxLayout::Interleaved, true>)
+    ->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_complex<double, CxLayout::Split, true>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_complex<float, CxLayout::Interleaved, false>)
+    ->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_complex<float, CxLayout::Split, false>)->ArgsProduct(ARGS);
+
+const std::vector<std::vector<int64_t>> COMPLEX_FFT_ARGS{
+    {8192},
+    {65, 245, 1024},
+};
+
+template <fftconv::FloatOrDouble Real, CxLayout Layout>
+void BM_conv1d_complex_fft(benchmark::State &state) {
+  std::unique_ptr<ComplexFFTConvolver<Real>> conv;
+  conv_bench_complex<Real, Layout, false>(
+      state, [&](auto &&input, auto &&kernel, auto &&output) {
+        if (!conv) {
+          if constexpr (Layout == CxLayout::Interleaved) {
+            conv = std::make_unique<ComplexFFTConvolver<Real>>(
+                kernel, state.range(0));
+          } else {
+            std::vector<std::complex<Real>> h(kernel.size);
+            for (size_t j = 0; j < h.size(); ++j) {
+              h[j] = {kernel.re[j], kernel.im[j]};
+            }
+            conv = std::make_unique<ComplexFFTConvolver<Real>>(
+                std::span<const std::complex<Real>>(h), state.range(0));
+          }
+        }
+        conv->template conv<ConvMode::Full>(input, output);
+      });
+  state.SetLabel(fmt::format("nfft={}", conv->fft_size()));
+}
+BENCHMARK(BM_conv1d_complex_fft<double, CxLayout::Interleaved>)
+    ->ArgsProduct(COMPLEX_FFT_ARGS);
+BENCHMARK(BM_conv1d_complex_fft<double, CxLayout::Split>)
+    ->ArgsProduct(COMPLEX_FFT_ARGS);
+BENCHMARK(BM_conv1d_complex<double, CxLayout::Interleaved, false>)
+    ->ArgsProduct(COMPLEX_FFT_ARGS);
+
 // template <fftconv::FloatOrDouble Real>
 // void BM_conv1d_OpenCV_intrin(benchmark::State &state) {
 //   conv_bench_same<Real>(state, conv1d_OpenCV_intrin<Real>);
 // }
 // BENCHMARK(BM_conv1d_OpenCV_intrin<double>)->ArgsProduct(ARGS);
 
+/*
+Hand-written SIMD direct convolution (register-blocked outputs)
+*/
+#if defined(__AVX2__)
+template <fftconv::FloatOrDouble Real, ConvMode Mode>
+void BM_conv1d_simd_avx2(benchmark::State &state) {
+  conv_bench<Real, Mode>(state, conv1d_simd_avx2<Real, Mode>);
+}
+BENCHMARK(BM_conv1d_simd_avx2<double, ConvMode::Full>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_simd_avx2<double, ConvMode::Same>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_simd_avx2<double, ConvMode::Valid>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_simd_avx2<float, ConvMode::Full>)->ArgsProduct(ARGS);
+#endif
+
+#if defined(__AVX512F__)
+template <fftconv::FloatOrDouble Real, ConvMode Mode>
+void BM_conv1d_simd_avx512(benchmark::State &state) {
+  conv_bench<Real, Mode>(state, conv1d_simd_avx512<Real, Mode>);
+}
+BENCHMARK(BM_conv1d_simd_avx512<double, ConvMode::Full>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_simd_avx512<double, ConvMode::Same>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_simd_avx512<double, ConvMode::Valid>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_simd_avx512<float, ConvMode::Full>)->ArgsProduct(ARGS);
+#endif
+
+#if defined(__ARM_NEON__)
+template <fftconv::FloatOrDouble Real, ConvMode Mode>
+void BM_conv1d_simd_neon(benchmark::State &state) {
+  conv_bench<Real, Mode>(state, conv1d_simd_neon<Real, Mode>);
+}
+BENCHMARK(BM_conv1d_simd_neon<double, ConvMode::Full>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_simd_neon<double, ConvMode::Same>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_simd_neon<double, ConvMode::Valid>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_simd_neon<float, ConvMode::Full>)->ArgsProduct(ARGS);
+#endif
+
 #endif // RUN_ALL
 
 // template <fftconv::FloatOrDouble Real>
@@ -162,6 +494,415 @@ void BM_conv1d_fftconv_oa_same(benchmark::State &state) {
 }
 // BENCHMARK(BM_conv1d_fftconv_oa_same<double>)->ArgsProduct(ARGS);
 
+/*
+FFTConvolver: kernel spectrum computed once vs. on every call
+*/
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_fft_convolver(benchmark::State &state) {
+  std::unique_ptr<FFTConvolver<Real>> conv;
+  conv_bench_full<Real>(state, [&](std::span<const Real> input,
+                                   std::span<const Real> kernel,
+                                   std::span<Real> output) {
+    if (!conv) {
+      conv = std::make_unique<FFTConvolver<Real>>(kernel, input.size());
+    }
+    conv->template conv<ConvMode::Full>(input, output);
+  });
+  state.SetLabel(fmt::format("nfft={}", conv->fft_size()));
+}
+BENCHMARK(BM_conv1d_fft_convolver<double>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_fft_convolver<float>)->ArgsProduct(ARGS);
+
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_fft_convolver_setup(benchmark::State &state) {
+  conv_bench_full<Real>(state, [](std::span<const Real> input,
+                                  std::span<const Real> kernel,
+                                  std::span<Real> output) {
+    FFTConvolver<Real> conv(kernel, input.size());
+    conv.template conv<ConvMode::Full>(input, output);
+  });
+}
+BENCHMARK(BM_conv1d_fft_convolver_setup<double>)->ArgsProduct(ARGS);
+
+/*
+conv1d_auto: the first (untimed) call tunes the shape, the label shows the
+backend it picked
+*/
+template <fftconv::FloatOrDouble Real, ConvMode Mode>
+void BM_conv1d_auto(benchmark::State &state) {
+  conv_bench<Real, Mode>(state, conv1d_auto<Real, Mode>);
+  state.SetLabel(to_string(
+      conv1d_auto_backend<Real, Mode>(state.range(0), state.range(1))));
+}
+BENCHMARK(BM_conv1d_auto<double, ConvMode::Full>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_auto<double, ConvMode::Same>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_auto<double, ConvMode::Valid>)->ArgsProduct(ARGS);
+BENCHMARK(BM_conv1d_auto<float, ConvMode::Full>)->ArgsProduct(ARGS);
+
+/*
+Filter banks, "same" mode
+(input size, kernel size, bank size)
+*/
+const std::vector<std::vector<int64_t>> BANK_ARGS{
+    ARGS[0],
+    ARGS[1],
+    {1, 8, 16, 32, 64},
+};
+
+template <typename T, typename Func>
+void bank_bench(benchmark::State &state, Func bank_func) {
+  const auto n_kernels = static_cast<size_t>(state.range(2));
+  arma::Col<T> input(state.range(0), arma::fill::randn);
+  arma::Col<T> kernels(state.range(1) * n_kernels, arma::fill::randn);
+  arma::Col<T> output(input.size() * n_kernels);
+
+  bank_func(input, kernels, n_kernels, output);
+  for (auto _ : state) {
+    bank_func(input, kernels, n_kernels, output);
+  }
+  state.SetItemsProcessed(state.iterations() * input.size() * n_kernels);
+}
+
+// Baseline: one conv1d_simd call (one pass over the input) per kernel
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_bank_loop(benchmark::State &state) {
+  bank_bench<Real>(state, [](std::span<const Real> input,
+                             std::span<const Real> kernels, size_t n_kernels,
+                             std::span<Real> output) {
+    const size_t k = kernels.size() / n_kernels;
+    const size_t n = input.size();
+    for (size_t f = 0; f < n_kernels; ++f) {
+      conv1d_simd<Real, ConvMode::Same>(input, kernels.subspan(f * k, k),
+                                        output.subspan(f * n, n));
+    }
+  });
+}
+BENCHMARK(BM_conv1d_bank_loop<double>)->ArgsProduct(BANK_ARGS);
+
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_bank_simd(benchmark::State &state) {
+  bank_bench<Real>(state, conv1d_bank_simd<Real, ConvMode::Same>);
+}
+BENCHMARK(BM_conv1d_bank_simd<double>)->ArgsProduct(BANK_ARGS);
+
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_bank_BLAS(benchmark::State &state) {
+  bank_bench<Real>(state, conv1d_bank_BLAS<Real, ConvMode::Same>);
+}
+BENCHMARK(BM_conv1d_bank_BLAS<double>)->ArgsProduct(BANK_ARGS);
+
+// Kernel spectra are computed once, outside the timed loop
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_bank_fft(benchmark::State &state) {
+  std::unique_ptr<FFTFilterBank<Real>> bank;
+  bank_bench<Real>(state, [&](std::span<const Real> input,
+                              std::span<const Real> kernels, size_t n_kernels,
+                              std::span<Real> output) {
+    if (!bank) {
+      bank = std::make_unique<FFTFilterBank<Real>>(kernels, n_kernels);
+    }
+    bank->template conv<ConvMode::Same>(input, output);
+  });
+}
+BENCHMARK(BM_conv1d_bank_fft<double>)->ArgsProduct(BANK_ARGS);
+
+/*
+Streaming conv1d: sustained throughput over many consecutive blocks
+(block size, kernel size)
+*/
+const std::vector<std::vector<int64_t>> STREAM_ARGS{
+    {1024, 4096},
+    {33, 165, 245},
+};
+
+template <fftconv::FloatOrDouble Real, StreamPath Path>
+void BM_conv1d_stream(benchmark::State &state) {
+  const auto block = state.range(0);
+  constexpr int64_t n_blocks = 64;
+
+  arma::Col<Real> input(block * n_blocks, arma::fill::randn);
+  arma::Col<Real> kernel(state.range(1), arma::fill::randn);
+  arma::Col<Real> output(input.size());
+
+  const std::span<const Real> in(input);
+  const std::span<Real> out(output);
+
+  StreamingConv1d<Real> conv(kernel, Path);
+  for (auto _ : state) {
+    for (int64_t b = 0; b < n_blocks; ++b) {
+      conv.process(in.subspan(b * block, block),
+                   out.subspan(b * block, block));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * block * n_blocks);
+}
+BENCHMARK(BM_conv1d_stream<double, StreamPath::Auto>)
+    ->ArgsProduct(STREAM_ARGS);
+BENCHMARK(BM_conv1d_stream<double, StreamPath::Direct>)
+    ->ArgsProduct(STREAM_ARGS);
+BENCHMARK(BM_conv1d_stream<double, StreamPath::FFT>)->ArgsProduct(STREAM_ARGS);
+
+/*
+Low latency streaming with long kernels (block size, kernel size).
+One iteration is one block, so the time per iteration is the per-block
+latency and items/s is the sustained throughput.
+*/
+const std::vector<std::vector<int64_t>> PARTITIONED_ARGS{
+    {64, 128, 256},
+    {1024, 4096, 16384},
+};
+
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_partitioned(benchmark::State &state) {
+  const auto block = state.range(0);
+  constexpr int64_t n_blocks = 64;
+
+  arma::Col<Real> input(block * n_blocks, arma::fill::randn);
+  arma::Col<Real> kernel(state.range(1), arma::fill::randn);
+  arma::Col<Real> output(input.size());
+
+  const std::span<const Real> in(input);
+  const std::span<Real> out(output);
+
+  PartitionedConvolver<Real> conv(kernel, block);
+  int64_t b = 0;
+  for (auto _ : state) {
+    conv.process(in.subspan(b * block, block), out.subspan(b * block, block));
+    b = (b + 1) % n_blocks;
+  }
+  state.SetItemsProcessed(state.iterations() * block);
+  state.SetLabel(fmt::format("partitions={}", conv.partitions));
+}
+BENCHMARK(BM_conv1d_partitioned<double>)->ArgsProduct(PARTITIONED_ARGS);
+BENCHMARK(BM_conv1d_partitioned<float>)->ArgsProduct(PARTITIONED_ARGS);
+
+// Same blocks through the single-FFT streaming path for reference
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_partitioned_vs_stream(benchmark::State &state) {
+  const auto block = state.range(0);
+  constexpr int64_t n_blocks = 64;
+
+  arma::Col<Real> input(block * n_blocks, arma::fill::randn);
+  arma::Col<Real> kernel(state.range(1), arma::fill::randn);
+  arma::Col<Real> output(input.size());
+
+  const std::span<const Real> in(input);
+  const std::span<Real> out(output);
+
+  StreamingConv1d<Real> conv(kernel, StreamPath::FFT);
+  int64_t b = 0;
+  for (auto _ : state) {
+    conv.process(in.subspan(b * block, block), out.subspan(b * block, block));
+    b = (b + 1) % n_blocks;
+  }
+  state.SetItemsProcessed(state.iterations() * block);
+}
+BENCHMARK(BM_conv1d_partitioned_vs_stream<double>)
+    ->ArgsProduct(PARTITIONED_ARGS);
+
+/*
+Polyphase resampling (factor, kernel size), items are output samples.
+The "full_rate" variants filter at the high rate with conv1d_simd and
+decimate / zero stuff around it, for reference.
+*/
+const std::vector<std::vector<int64_t>> POLYPHASE_ARGS{
+    {2, 4, 8},
+    {33, 165, 245},
+};
+constexpr int64_t POLYPHASE_N = 8192;
+
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_decimate(benchmark::State &state) {
+  const auto factor = static_cast<size_t>(state.range(0));
+  arma::Col<Real> input(POLYPHASE_N, arma::fill::randn);
+  arma::Col<Real> kernel(state.range(1), arma::fill::randn);
+
+  PolyphaseDecimator<Real> dec(kernel, factor);
+  arma::Col<Real> output(dec.output_size(input.size()));
+  for (auto _ : state) {
+    dec.process(input, output);
+    dec.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * output.size());
+}
+BENCHMARK(BM_conv1d_decimate<double>)->ArgsProduct(POLYPHASE_ARGS);
+BENCHMARK(BM_conv1d_decimate<float>)->ArgsProduct(POLYPHASE_ARGS);
+
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_decimate_full_rate(benchmark::State &state) {
+  const auto factor = static_cast<size_t>(state.range(0));
+  arma::Col<Real> input(POLYPHASE_N, arma::fill::randn);
+  arma::Col<Real> kernel(state.range(1), arma::fill::randn);
+  arma::Col<Real> filtered(input.size() + kernel.size() - 1);
+  arma::Col<Real> output((input.size() + factor - 1) / factor);
+
+  for (auto _ : state) {
+    conv1d_simd<Real, ConvMode::Full>(input, kernel, filtered);
+    for (size_t m = 0; m < output.size(); ++m) {
+      output[m] = filtered[m * factor];
+    }
+    benchmark::DoNotOptimize(output.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * output.size());
+}
+BENCHMARK(BM_conv1d_decimate_full_rate<double>)->ArgsProduct(POLYPHASE_ARGS);
+
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_interpolate(benchmark::State &state) {
+  const auto factor = static_cast<size_t>(state.range(0));
+  arma::Col<Real> input(POLYPHASE_N, arma::fill::randn);
+  arma::Col<Real> kernel(state.range(1), arma::fill::randn);
+
+  PolyphaseInterpolator<Real> itp(kernel, factor);
+  arma::Col<Real> output(itp.output_size(input.size()));
+  for (auto _ : state) {
+    itp.process(input, output);
+  }
+  state.SetItemsProcessed(state.iterations() * output.size());
+}
+BENCHMARK(BM_conv1d_interpolate<double>)->ArgsProduct(POLYPHASE_ARGS);
+BENCHMARK(BM_conv1d_interpolate<float>)->ArgsProduct(POLYPHASE_ARGS);
+
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_interpolate_full_rate(benchmark::State &state) {
+  const auto factor = static_cast<size_t>(state.range(0));
+  arma::Col<Real> input(POLYPHASE_N, arma::fill::randn);
+  arma::Col<Real> kernel(state.range(1), arma::fill::randn);
+  arma::Col<Real> stuffed(input.size() * factor, arma::fill::zeros);
+  arma::Col<Real> output(stuffed.size() + kernel.size() - 1);
+
+  for (auto _ : state) {
+    for (size_t m = 0; m < input.size(); ++m) {
+      stuffed[m * factor] = input[m];
+    }
+    conv1d_simd<Real, ConvMode::Full>(stuffed, kernel, output);
+  }
+  state.SetItemsProcessed(state.iterations() * stuffed.size());
+}
+BENCHMARK(BM_conv1d_interpolate_full_rate<double>)
+    ->ArgsProduct(POLYPHASE_ARGS);
+
+/*
+Batched conv1d: one kernel applied to many channels
+(channels, signal length, kernel size)
+*/
+const std::vector<std::vector<int64_t>> BATCH_ARGS{
+    {1, 4, 16, 64, 256, 1024},
+    {2048},
+    {33, 165},
+};
+
+template <fftconv::FloatOrDouble Real, bool Interleaved, BatchStrategy Strategy,
+          bool Parallel = false>
+void BM_conv1d_batch(benchmark::State &state) {
+  const auto channels = static_cast<size_t>(state.range(0));
+  const auto length = static_cast<size_t>(state.range(1));
+  arma::Col<Real> kernel(state.range(2), arma::fill::randn);
+  const auto n_out = length + kernel.size() - 1;
+
+  // Column major: channel major is one column per channel,
+  // interleaved is one column per time sample
+  arma::Mat<Real> input;
+  arma::Mat<Real> output;
+  StridedChannels<Real> in{};
+  StridedChannels<Real> out{};
+  if constexpr (Interleaved) {
+    input.randn(channels, length);
+    output.set_size(channels, n_out);
+    in = StridedChannels<Real>::interleaved(input.memptr(), length, channels);
+    out = StridedChannels<Real>::interleaved(output.memptr(), n_out, channels);
+  } else {
+    input.randn(length, channels);
+    output.set_size(n_out, channels);
+    in = StridedChannels<Real>::channel_major(input.memptr(), length, channels);
+    out =
+        StridedChannels<Real>::channel_major(output.memptr(), n_out, channels);
+  }
+
+  conv1d_batch<Real>(in, kernel, out, Strategy, Parallel);
+  for (auto _ : state) {
+    conv1d_batch<Real>(in, kernel, out, Strategy, Parallel);
+  }
+  state.SetItemsProcessed(state.iterations() * channels * length);
+}
+BENCHMARK(BM_conv1d_batch<double, false, BatchStrategy::AcrossTime>)
+    ->ArgsProduct(BATCH_ARGS);
+BENCHMARK(BM_conv1d_batch<double, true, BatchStrategy::AcrossTime>)
+    ->ArgsProduct(BATCH_ARGS);
+BENCHMARK(BM_conv1d_batch<double, true, BatchStrategy::AcrossChannels>)
+    ->ArgsProduct(BATCH_ARGS);
+BENCHMARK(BM_conv1d_batch<float, true, BatchStrategy::AcrossChannels>)
+    ->ArgsProduct(BATCH_ARGS);
+BENCHMARK(BM_conv1d_batch<double, false, BatchStrategy::AcrossTime, true>)
+    ->ArgsProduct(BATCH_ARGS)
+    ->UseRealTime();
+BENCHMARK(BM_conv1d_batch<double, true, BatchStrategy::AcrossChannels, true>)
+    ->ArgsProduct(BATCH_ARGS)
+    ->UseRealTime();
+
+/*
+Tiled multithreaded conv1d on long signals
+(signal length, kernel size, threads)
+*/
+// 1, 2, 4, ... up to all cores
+inline auto thread_counts() -> std::vector<int64_t> {
+  const int64_t n_cpus = cv::getNumberOfCPUs();
+  std::vector<int64_t> counts;
+  for (int64_t t = 1; t < n_cpus; t *= 2) { counts.push_back(t); }
+  counts.push_back(n_cpus);
+  return counts;
+}
+
+const std::vector<std::vector<int64_t>> PARALLEL_ARGS{
+    {1 << 20, 1 << 22},
+    {33, 165, 1025},
+    thread_counts(),
+};
+
+template <fftconv::FloatOrDouble Real, Conv1dBackend Backend>
+void BM_conv1d_parallel(benchmark::State &state) {
+  arma::Col<Real> input(state.range(0), arma::fill::randn);
+  arma::Col<Real> kernel(state.range(1), arma::fill::randn);
+  arma::Col<Real> output(input.size() + kernel.size() - 1);
+
+  const auto prev_threads = cv::getNumThreads();
+  cv::setNumThreads(static_cast<int>(state.range(2)));
+
+  conv1d_parallel<Real>(input, kernel, output, Backend);
+  for (auto _ : state) {
+    conv1d_parallel<Real>(input, kernel, output, Backend);
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+
+  cv::setNumThreads(prev_threads);
+}
+BENCHMARK(BM_conv1d_parallel<double, Conv1dBackend::SIMD>)
+    ->ArgsProduct(PARALLEL_ARGS)
+    ->UseRealTime();
+BENCHMARK(BM_conv1d_parallel<float, Conv1dBackend::SIMD>)
+    ->ArgsProduct(PARALLEL_ARGS)
+    ->UseRealTime();
+BENCHMARK(BM_conv1d_parallel<double, Conv1dBackend::BLAS>)
+    ->ArgsProduct(PARALLEL_ARGS)
+    ->UseRealTime();
+
+// Throughput ceiling: every benchmark thread filters its own signal
+template <fftconv::FloatOrDouble Real>
+void BM_conv1d_simd_threads(benchmark::State &state) {
+  arma::Col<Real> input(state.range(0), arma::fill::randn);
+  arma::Col<Real> kernel(state.range(1), arma::fill::randn);
+  arma::Col<Real> output(input.size() + kernel.size() - 1);
+
+  for (auto _ : state) {
+    conv1d_simd<Real, ConvMode::Full>(input, kernel, output);
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_conv1d_simd_threads<double>)
+    ->ArgsProduct({{1 << 20}, {33, 165, 1025}})
+    ->ThreadRange(1, cv::getNumberOfCPUs())
+    ->UseRealTime();
+
 #ifdef HAS_IPP
 
 template <fftconv::FloatOrDouble Real>
@@ -193,6 +934,7 @@ BENCHMARK(BM_conv1d_Accelerate_vDSP<double>)->ArgsProduct(ARGS);
 
 int main(int argc, char **argv) {
   fftw::WisdomSetup fftwWisdom;
+  Conv1dAutotuneSetup conv1dAutotune;
 
   benchmark::Initialize(&argc, argv);
   benchmark::RunSpecifiedBenchmarks();
@@ -1,15 +1,27 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <array>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 #include <kfr/all.hpp>
 #include <opencv2/core/hal/intrin.hpp>
 #include <opencv2/opencv.hpp>
 #include <span>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 #ifdef __APPLE__
 #include <Accelerate/Accelerate.h>
 #else
@@ -126,6 +138,29 @@ void conv1d_IPP(const std::span<const T> input, const std::span<const T> kernel,
 
 enum class ConvMode { Full, Same, Valid };
 
+// Output length of an input of size n convolved with a kernel of size k
+template <ConvMode Mode>
+constexpr auto conv1d_output_size(size_t n, size_t k) -> size_t {
+  if constexpr (Mode == ConvMode::Full) {
+    return n + k - 1;
+  } else if constexpr (Mode == ConvMode::Same) {
+    return n;
+  } else {
+    return n - k + 1;
+  }
+}
+
+// Number of zeros implicitly padded before the input
+template <ConvMode Mode> constexpr auto conv1d_pad(size_t k) -> size_t {
+  if constexpr (Mode == ConvMode::Full) {
+    return k - 1;
+  } else if constexpr (Mode == ConvMode::Same) {
+    return (k - 1) / 2;
+  } else {
+    return 0;
+  }
+}
+
 /*
 Naive
 */
@@ -172,7 +207,41 @@ void conv1d_naive(const std::span<const T> input,
 }
 
 /*
-Conv1d with BLAS using the im2col method + gemm
+Row-major BLAS wrappers
+gemv: y = A x, A is m x n
+gemm: C = A B^T, A is m x k, B is n x k, C is m x n
+*/
+template <typename T>
+void blas_gemv(int m, int n, const T *A, const T *x, T *y)
+  requires(std::is_floating_point_v<T>)
+{
+  if constexpr (std::is_same_v<T, float>) {
+    cblas_sgemv(CblasRowMajor, CblasNoTrans, m, n, 1.0F, A, n, x, 1, 0.0F, y,
+                1);
+  } else if constexpr (std::is_same_v<T, double>) {
+    cblas_dgemv(CblasRowMajor, CblasNoTrans, m, n, 1.0, A, n, x, 1, 0.0, y, 1);
+  } else {
+    static_assert(std::is_same_v<T, float>, "Unsupported type");
+  }
+}
+
+template <typename T>
+void blas_gemm_nt(int m, int n, int k, const T *A, const T *B, T *C)
+  requires(std::is_floating_point_v<T>)
+{
+  if constexpr (std::is_same_v<T, float>) {
+    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, m, n, k, 1.0F, A, k,
+                B, k, 0.0F, C, n);
+  } else if constexpr (std::is_same_v<T, double>) {
+    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasTrans, m, n, k, 1.0, A, k, B,
+                k, 0.0, C, n);
+  } else {
+    static_assert(std::is_same_v<T, float>, "Unsupported type");
+  }
+}
+
+/*
+Conv1d with BLAS using the im2col method + gemv
 "valid" mode
 
 im2col_matrix must be preallocated to have size output_size * kernel_size,
@@ -189,33 +258,21 @@ void conv1d_BLAS_im2col(std::span<const T> input, std::span<const T> kernel,
 
   // Perform im2col transformation
   for (int i = 0; i < output_size; ++i) {
-    for (int j = 0; j < kernel_size; ++j) {
-      im2col_matrix[i * kernel_size + j] = input[i + j];
-    }
+    std::copy(input.begin() + i, input.begin() + i + kernel_size,
+              im2col_matrix.begin() + i * kernel_size);
   }
 
-  // Perform matrix multiplication: output = im2col_matrix * kernel
-  // cblas_sgemm performs: C = alpha * A * B + beta * C
-  // Here, we set alpha=1 and beta=0
-  if constexpr (std::is_same_v<T, float>) {
-    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, output_size, 1,
-                kernel_size, 1.0F, im2col_matrix.data(), kernel_size,
-                kernel.data(), 1, 0.0F, output.data(), 1);
-  } else if constexpr (std::is_same_v<T, double>) {
-    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, output_size, 1,
-                kernel_size, 1.0, im2col_matrix.data(), kernel_size,
-                kernel.data(), 1, 0.0, output.data(), 1);
-  } else {
-    static_assert(false, "Unsupported type");
-  }
+  // output = im2col_matrix * kernel
+  blas_gemv<T>(output_size, kernel_size, im2col_matrix.data(), kernel.data(),
+               output.data());
 }
 
 /*
-Conv1d with BLAS using the im2col method + gemm.
+Conv1d with BLAS using the im2col method + gemv.
 "same" mode
 
-im2col_matrix must be preallocated to have size output_size * kernel_size,
-where output_size = input_size - kernel_size + 1
+im2col_matrix must be preallocated to have size input_size * kernel_size
+(the "same" output size is the input size)
 */
 template <typename T>
 void conv1d_BLAS_same(std::span<const T> input, std::span<const T> kernel,
@@ -224,41 +281,109 @@ void conv1d_BLAS_same(std::span<const T> input, std::span<const T> kernel,
 {
   const int input_size = input.size();
   const int kernel_size = kernel.size();
-
-  // Calculate the required padding for "same" mode
   const int padding = (kernel_size - 1) / 2;
-  const int padded_size = input_size + 2 * padding;
-
-  // Create a padded input
-  std::vector<T> padded_input(padded_size, 0.0F);
-  for (int i = 0; i < input_size; ++i) {
-    padded_input[i + padding] = input[i];
-  }
 
   // The output size will be the same as the original input size
   const int output_size = input_size;
 
-  // Perform im2col transformation on the padded input
+  // im2col straight from the input; taps that fall in the zero padding are
+  // written as zeros instead of copying through a padded buffer
   for (int i = 0; i < output_size; ++i) {
-    for (int j = 0; j < kernel_size; ++j) {
-      im2col_matrix[i * kernel_size + j] = padded_input[i + j];
+    T *row = im2col_matrix.data() + i * kernel_size;
+    const int j_lo = std::max(0, padding - i);
+    const int j_hi = std::min(kernel_size, input_size + padding - i);
+    std::fill(row, row + j_lo, T{});
+    std::copy(input.begin() + (i + j_lo - padding),
+              input.begin() + (i + j_hi - padding), row + j_lo);
+    std::fill(row + j_hi, row + kernel_size, T{});
+  }
+
+  blas_gemv<T>(output_size, kernel_size, im2col_matrix.data(), kernel.data(),
+               output.data());
+}
+
+/*
+Reusable BLAS conv1d state (conv1d_naive semantics, any ConvMode).
+
+Owns the zero padded input and the im2col (Toeplitz) matrix, so repeated
+calls with the same shapes don't allocate. A single kernel runs as a GEMV;
+a bank of kernels shares one im2col matrix and runs as a single GEMM.
+*/
+template <typename T>
+  requires(std::is_floating_point_v<T>)
+struct Conv1dBLASWorkspace {
+  std::vector<T> padded;
+  std::vector<T> im2col;
+
+  // output.size() >= conv1d_output_size<Mode>(input.size(), kernel.size())
+  template <ConvMode Mode = ConvMode::Full>
+  void conv(std::span<const T> input, std::span<const T> kernel,
+            std::span<T> output) {
+    const size_t k = kernel.size();
+    const size_t n_out = build<Mode>(input, k);
+    if (output.size() < n_out) {
+      throw std::invalid_argument(
+          "Output span size is too small for the selected mode");
     }
+    blas_gemv<T>(static_cast<int>(n_out), static_cast<int>(k), im2col.data(),
+                 kernel.data(), output.data());
   }
 
-  if constexpr (std::is_same_v<T, float>) {
-    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, output_size, 1,
-                kernel_size, 1.0F, im2col_matrix.data(), kernel_size,
-                kernel.data(), 1, 0.0F, output.data(), 1);
-  } else if constexpr (std::is_same_v<T, double>) {
-    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, output_size, 1,
-                kernel_size, 1.0, im2col_matrix.data(), kernel_size,
-                kernel.data(), 1, 0.0, output.data(), 1);
-  } else {
-    static_assert(false, "Unsupported type");
+  /*
+  Filter bank: `kernels` holds n_kernels kernels of length k back to back.
+  Output f occupies output[f * n_out, (f + 1) * n_out).
+  */
+  template <ConvMode Mode = ConvMode::Full>
+  void conv_bank(std::span<const T> input, std::span<const T> kernels,
+                 size_t n_kernels, std::span<T> output) {
+    if (n_kernels == 0 || kernels.size() % n_kernels != 0) {
+      throw std::invalid_argument(
+          "Kernel bank size is not a multiple of the number of kernels");
+    }
+    const size_t k = kernels.size() / n_kernels;
+    const size_t n_out = build<Mode>(input, k);
+    if (output.size() < n_out * n_kernels) {
+      throw std::invalid_argument(
+          "Output span size is too small for the selected mode");
+    }
+
+    if (n_kernels == 1) {
+      blas_gemv<T>(static_cast<int>(n_out), static_cast<int>(k),
+                   im2col.data(), kernels.data(), output.data());
+    } else {
+      // (n_kernels x k) * (n_out x k)^T
+      blas_gemm_nt<T>(static_cast<int>(n_kernels), static_cast<int>(n_out),
+                      static_cast<int>(k), kernels.data(), im2col.data(),
+                      output.data());
+    }
   }
 
-  return output;
-}
+private:
+  // Fill the im2col matrix for this input, returns the output size
+  template <ConvMode Mode>
+  auto build(std::span<const T> input, size_t k) -> size_t {
+    if (k == 0 || (Mode == ConvMode::Valid && input.size() < k)) {
+      throw std::invalid_argument("Invalid input and kernel sizes");
+    }
+    const size_t n_out = conv1d_output_size<Mode>(input.size(), k);
+
+    const T *src = input.data();
+    if constexpr (Mode != ConvMode::Valid) {
+      const size_t pad = conv1d_pad<Mode>(k);
+      padded.resize(n_out + k - 1);
+      std::fill(padded.begin(), padded.begin() + pad, T{});
+      std::copy(input.begin(), input.end(), padded.begin() + pad);
+      std::fill(padded.begin() + pad + input.size(), padded.end(), T{});
+      src = padded.data();
+    }
+
+    im2col.resize(n_out * k);
+    for (size_t i = 0; i < n_out; ++i) {
+      std::copy(src + i, src + i + k, im2col.data() + i * k);
+    }
+    return n_out;
+  }
+};
 
 #ifdef __APPLE__
 
@@ -399,7 +524,7 @@ void conv1d_OpenCV_intrin(const std::span<const T> input,
     WideFloat kernel_wide = cv::vx_setall(kernel[k]);
 
     int i = 0;
-    for (; i + step < input.size(); i += step) {
+    for (; i + step <= output.size(); i += step) {
       WideFloat window = cv::vx_load(sptr + i + k);
       WideFloat sum =
           cv::v_add(cv::vx_load(dptr + i), cv::v_mul(kernel_wide, window));
@@ -411,3 +536,526 @@ void conv1d_OpenCV_intrin(const std::span<const T> input,
     }
   }
 }
+
+/*
+Hand-written SIMD direct convolution (same semantics as conv1d_naive)
+
+The inner loop keeps `Blocks` output vectors in registers across all kernel
+taps, so each output is stored exactly once instead of once per tap.
+"Full" and "Same" modes zero-pad the input into a thread_local buffer and run
+the "valid" kernel on it.
+*/
+namespace simd {
+
+#if defined(__AVX2__)
+
+template <typename T> struct AVX2;
+template <> struct AVX2<float> {
+  using V = __m256;
+  static constexpr size_t W = 8;
+  static auto zero() -> V { return _mm256_setzero_ps(); }
+  static auto set1(float x) -> V { return _mm256_set1_ps(x); }
+  static auto loadu(const float *p) -> V { return _mm256_loadu_ps(p); }
+  static void storeu(float *p, V v) { _mm256_storeu_ps(p, v); }
+  static auto fmadd(V a, V b, V c) -> V { return _mm256_fmadd_ps(a, b, c); }
+  static auto add(V a, V b) -> V { return _mm256_add_ps(a, b); }
+  static auto sub(V a, V b) -> V { return _mm256_sub_ps(a, b); }
+};
+template <> struct AVX2<double> {
+  using V = __m256d;
+  static constexpr size_t W = 4;
+  static auto zero() -> V { return _mm256_setzero_pd(); }
+  static auto set1(double x) -> V { return _mm256_set1_pd(x); }
+  static auto loadu(const double *p) -> V { return _mm256_loadu_pd(p); }
+  static void storeu(double *p, V v) { _mm256_storeu_pd(p, v); }
+  static auto fmadd(V a, V b, V c) -> V { return _mm256_fmadd_pd(a, b, c); }
+  static auto add(V a, V b) -> V { return _mm256_add_pd(a, b); }
+  static auto sub(V a, V b) -> V { return _mm256_sub_pd(a, b); }
+};
+
+#endif
+
+#if defined(__AVX512F__)
+
+template <typename T> struct AVX512;
+template <> struct AVX512<float> {
+  using V = __m512;
+  static constexpr size_t W = 16;
+  static auto zero() -> V { return _mm512_setzero_ps(); }
+  static auto set1(float x) -> V { return _mm512_set1_ps(x); }
+  static auto loadu(const float *p) -> V { return _mm512_loadu_ps(p); }
+  static void storeu(float *p, V v) { _mm512_storeu_ps(p, v); }
+  static auto fmadd(V a, V b, V c) -> V { return _mm512_fmadd_ps(a, b, c); }
+  static auto add(V a, V b) -> V { return _mm512_add_ps(a, b); }
+  static auto sub(V a, V b) -> V { return _mm512_sub_ps(a, b); }
+};
+template <> struct AVX512<double> {
+  using V = __m512d;
+  static constexpr size_t W = 8;
+  static auto zero() -> V { return _mm512_setzero_pd(); }
+  static auto set1(double x) -> V { return _mm512_set1_pd(x); }
+  static auto loadu(const double *p) -> V { return _mm512_loadu_pd(p); }
+  static void storeu(double *p, V v) { _mm512_storeu_pd(p, v); }
+  static auto fmadd(V a, V b, V c) -> V { return _mm512_fmadd_pd(a, b, c); }
+  static auto add(V a, V b) -> V { return _mm512_add_pd(a, b); }
+  static auto sub(V a, V b) -> V { return _mm512_sub_pd(a, b); }
+};
+
+#endif
+
+#if defined(__ARM_NEON__)
+
+template <typename T> struct NEON;
+template <> struct NEON<float> {
+  using V = float32x4_t;
+  static constexpr size_t W = 4;
+  static auto zero() -> V { return vdupq_n_f32(0); }
+  static auto set1(float x) -> V { return vdupq_n_f32(x); }
+  static auto loadu(const float *p) -> V { return vld1q_f32(p); }
+  static void storeu(float *p, V v) { vst1q_f32(p, v); }
+  static auto fmadd(V a, V b, V c) -> V { return vfmaq_f32(c, a, b); }
+  static auto add(V a, V b) -> V { return vaddq_f32(a, b); }
+  static auto sub(V a, V b) -> V { return vsubq_f32(a, b); }
+};
+template <> struct NEON<double> {
+  using V = float64x2_t;
+  static constexpr size_t W = 2;
+  static auto zero() -> V { return vdupq_n_f64(0); }
+  static auto set1(double x) -> V { return vdupq_n_f64(x); }
+  static auto loadu(const double *p) -> V { return vld1q_f64(p); }
+  static void storeu(double *p, V v) { vst1q_f64(p, v); }
+  static auto fmadd(V a, V b, V c) -> V { return vfmaq_f64(c, a, b); }
+  static auto add(V a, V b) -> V { return vaddq_f64(a, b); }
+  static auto sub(V a, V b) -> V { return vsubq_f64(a, b); }
+};
+
+#endif
+
+// One lane "vector", used when no SIMD ISA is available
+template <typename T> struct Scalar {
+  using V = T;
+  static constexpr size_t W = 1;
+  static auto zero() -> V { return T{}; }
+  static auto set1(T x) -> V { return x; }
+  static auto loadu(const T *p) -> V { return *p; }
+  static void storeu(T *p, V v) { *p = v; }
+  static auto fmadd(V a, V b, V c) -> V { return a * b + c; }
+  static auto add(V a, V b) -> V { return a + b; }
+  static auto sub(V a, V b) -> V { return a - b; }
+};
+
+// Widest ops available for the target
+#if defined(__AVX512F__)
+template <typename T> using Native = AVX512<T>;
+#elif defined(__AVX2__)
+template <typename T> using Native = AVX2<T>;
+#elif defined(__ARM_NEON__)
+template <typename T> using Native = NEON<T>;
+#else
+template <typename T> using Native = Scalar<T>;
+#endif
+
+/*
+"valid" mode: out[i] = sum_j in[i + j] * kernel[j], for i in [0, n_out)
+`in` must hold n_out + k - 1 samples. With Accumulate, the sum is added to
+the existing out[i] instead (used to sum polyphase branches).
+
+The per-block loops are expanded with index_sequence folds so the
+accumulators stay in registers even without compiler loop unrolling.
+*/
+template <class Ops, bool Accumulate = false, typename T, size_t... B>
+inline void conv1d_block(const T *in, const T *kernel, size_t k, T *out,
+                         std::index_sequence<B...> /*blocks*/) {
+  using V = typename Ops::V;
+  constexpr size_t W = Ops::W;
+
+  // A plain array: std::array<V> would drop V's vector attributes
+  // (-Wignored-attributes)
+  V acc[sizeof...(B)]{ // NOLINT(*-avoid-c-arrays)
+      (Accumulate ? Ops::loadu(out + B * W) : Ops::zero())...};
+  for (size_t j = 0; j < k; ++j) {
+    const V kv = Ops::set1(kernel[j]);
+    const T *p = in + j;
+    ((acc[B] = Ops::fmadd(Ops::loadu(p + B * W), kv, acc[B])), ...);
+  }
+  (Ops::storeu(out + B * W, acc[B]), ...);
+}
+
+template <class Ops, size_t Blocks, bool Accumulate = false, typename T>
+void conv1d_valid_blocked(const T *in, size_t n_out, const T *kernel,
+                          size_t k, T *out) {
+  using V = typename Ops::V;
+  constexpr size_t W = Ops::W;
+  constexpr size_t step = W * Blocks;
+
+  size_t i = 0;
+  for (; i + step <= n_out; i += step) {
+    conv1d_block<Ops, Accumulate>(in + i, kernel, k, out + i,
+                                  std::make_index_sequence<Blocks>{});
+  }
+
+  // Remaining full vectors
+  for (; i + W <= n_out; i += W) {
+    V acc = Accumulate ? Ops::loadu(out + i) : Ops::zero();
+    for (size_t j = 0; j < k; ++j) {
+      acc = Ops::fmadd(Ops::loadu(in + i + j), Ops::set1(kernel[j]), acc);
+    }
+    Ops::storeu(out + i, acc);
+  }
+
+  // Scalar tail
+  for (; i < n_out; ++i) {
+    T acc = Accumulate ? out[i] : T{};
+    for (size_t j = 0; j < k; ++j) {
+      acc += in[i + j] * kernel[j];
+    }
+    out[i] = acc;
+  }
+}
+
+// Number of output vectors kept in registers per block
+inline constexpr size_t BLOCKS = 8;
+
+template <typename T, ConvMode Mode, class Ops>
+void conv1d(const std::span<const T> input, const std::span<const T> kernel,
+            std::span<T> output) {
+  const size_t k = kernel.size();
+  size_t output_size = 0;
+  size_t pad = 0;
+
+  if constexpr (Mode == ConvMode::Full) {
+    output_size = input.size() + k - 1;
+    pad = k - 1;
+  } else if constexpr (Mode == ConvMode::Same) {
+    output_size = input.size();
+    pad = (k - 1) / 2;
+  } else if constexpr (Mode == ConvMode::Valid) {
+    output_size = input.size() - k + 1;
+  }
+
+  if (output.size() < output_size) {
+    throw std::invalid_argument(
+        "Output span size is too small for the selected mode");
+  }
+
+  if constexpr (Mode == ConvMode::Valid) {
+    conv1d_valid_blocked<Ops, BLOCKS>(input.data(), output_size,
+                                      kernel.data(), k, output.data());
+  } else {
+    // Zero pad so that every output sees k valid input samples
+    thread_local std::vector<T> padded;
+    padded.assign(output_size + k - 1, T{});
+    std::copy(input.begin(), input.end(), padded.begin() + pad);
+
+    conv1d_valid_blocked<Ops, BLOCKS>(padded.data(), output_size,
+                                      kernel.data(), k, output.data());
+  }
+}
+
+/*
+Filter bank "valid" kernel: F filters x B output vectors per block.
+Each input vector is loaded once per tap and reused by all F filters, each
+filter tap is broadcast once and reused by all B vectors.
+kernels[f * k + j] is tap j of filter f, out[f * out_stride + i] its output.
+*/
+template <class Ops, size_t F, size_t B, typename T>
+inline void conv1d_bank_block(const T *in, const T *kernels, size_t k,
+                              T *out, size_t out_stride) {
+  using V = typename Ops::V;
+  constexpr size_t W = Ops::W;
+
+  // NOLINTBEGIN(*-avoid-c-arrays)
+  V acc[F * B];
+  for (auto &a : acc) { a = Ops::zero(); }
+  for (size_t j = 0; j < k; ++j) {
+    V x[B];
+    V kv[F];
+    [&]<size_t... b>(std::index_sequence<b...> /*blocks*/) {
+      ((x[b] = Ops::loadu(in + j + b * W)), ...);
+    }(std::make_index_sequence<B>{});
+    [&]<size_t... f>(std::index_sequence<f...> /*filters*/) {
+      ((kv[f] = Ops::set1(kernels[f * k + j])), ...);
+    }(std::make_index_sequence<F>{});
+    [&]<size_t... I>(std::index_sequence<I...> /*acc*/) {
+      ((acc[I] = Ops::fmadd(x[I % B], kv[I / B], acc[I])), ...);
+    }(std::make_index_sequence<F * B>{});
+  }
+  [&]<size_t... I>(std::index_sequence<I...> /*acc*/) {
+    (Ops::storeu(out + (I / B) * out_stride + (I % B) * W, acc[I]), ...);
+  }(std::make_index_sequence<F * B>{});
+  // NOLINTEND(*-avoid-c-arrays)
+}
+
+// Filters per block and output vectors per block (12 accumulators, which
+// leaves room for the loads and broadcasts in 16 AVX2/NEON registers)
+inline constexpr size_t BANK_FILTERS = 4;
+inline constexpr size_t BANK_BLOCKS = 3;
+
+// Filters [f_begin, f_begin + F) over n_out outputs
+template <class Ops, size_t F, typename T>
+void conv1d_bank_filters(const T *in, size_t n_out, const T *kernels,
+                         size_t k, T *out, size_t out_stride) {
+  constexpr size_t W = Ops::W;
+  constexpr size_t step = W * BANK_BLOCKS;
+
+  size_t i = 0;
+  for (; i + step <= n_out; i += step) {
+    conv1d_bank_block<Ops, F, BANK_BLOCKS>(in + i, kernels, k, out + i,
+                                           out_stride);
+  }
+  for (; i + W <= n_out; i += W) {
+    conv1d_bank_block<Ops, F, 1>(in + i, kernels, k, out + i, out_stride);
+  }
+  for (; i < n_out; ++i) {
+    conv1d_bank_block<Scalar<T>, F, 1>(in + i, kernels, k, out + i,
+                                       out_stride);
+  }
+}
+
+template <typename T, ConvMode Mode, class Ops>
+void conv1d_bank(const std::span<const T> input,
+                 const std::span<const T> kernels, size_t n_kernels,
+                 std::span<T> output) {
+  if (n_kernels == 0 || kernels.size() % n_kernels != 0) {
+    throw std::invalid_argument(
+        "Kernel bank size is not a multiple of the number of kernels");
+  }
+  const size_t k = kernels.size() / n_kernels;
+  if (k == 0 || (Mode == ConvMode::Valid && input.size() < k)) {
+    throw std::invalid_argument("Invalid input and kernel sizes");
+  }
+  const size_t n_out = conv1d_output_size<Mode>(input.size(), k);
+  if (output.size() < n_out * n_kernels) {
+    throw std::invalid_argument(
+        "Output span size is too small for the selected mode");
+  }
+
+  const T *in = input.data();
+  if constexpr (Mode != ConvMode::Valid) {
+    thread_local std::vector<T> padded;
+    padded.assign(n_out + k - 1, T{});
+    std::copy(input.begin(), input.end(),
+              padded.begin() + conv1d_pad<Mode>(k));
+    in = padded.data();
+  }
+
+  size_t f = 0;
+  for (; f + BANK_FILTERS <= n_kernels; f += BANK_FILTERS) {
+    conv1d_bank_filters<Ops, BANK_FILTERS>(in, n_out, kernels.data() + f * k,
+                                           k, output.data() + f * n_out,
+                                           n_out);
+  }
+  // Leftover filters: the single kernel path keeps more outputs in flight
+  for (; f < n_kernels; ++f) {
+    conv1d_valid_blocked<Ops, BLOCKS>(in, n_out, kernels.data() + f * k, k,
+                                      output.data() + f * n_out);
+  }
+}
+
+/*
+Linear-phase "valid" kernel: kernel[k - 1 - j] == +-kernel[j], so the two
+input samples sharing a tap are pre-added (subtracted for Anti) and each
+output takes ceil(k / 2) multiplies instead of k. The centre tap of an odd
+antisymmetric kernel is zero and skipped.
+*/
+template <class Ops, bool Anti, typename T, size_t... B>
+inline void conv1d_symmetric_block(const T *in, const T *kernel, size_t k,
+                                   T *out, std::index_sequence<B...> /*b*/) {
+  using V = typename Ops::V;
+  constexpr size_t W = Ops::W;
+
+  const auto pair = [](V a, V b) {
+    if constexpr (Anti) {
+      return Ops::sub(a, b);
+    } else {
+      return Ops::add(a, b);
+    }
+  };
+
+  V acc[sizeof...(B)]{ // NOLINT(*-avoid-c-arrays), see conv1d_block
+      (static_cast<void>(B), Ops::zero())...};
+  const size_t half = k / 2;
+  for (size_t j = 0; j < half; ++j) {
+    const V kv = Ops::set1(kernel[j]);
+    const T *lo = in + j;
+    const T *hi = in + (k - 1 - j);
+    ((acc[B] = Ops::fmadd(pair(Ops::loadu(lo + B * W), Ops::loadu(hi + B * W)),
+                          kv, acc[B])),
+     ...);
+  }
+  if (!Anti && k % 2 == 1) {
+    const V kv = Ops::set1(kernel[half]);
+    ((acc[B] = Ops::fmadd(Ops::loadu(in + half + B * W), kv, acc[B])), ...);
+  }
+  (Ops::storeu(out + B * W, acc[B]), ...);
+}
+
+template <class Ops, bool Anti, typename T>
+void conv1d_symmetric_valid(const T *in, size_t n_out, const T *kernel,
+                            size_t k, T *out) {
+  constexpr size_t W = Ops::W;
+  constexpr size_t step = W * BLOCKS;
+
+  size_t i = 0;
+  for (; i + step <= n_out; i += step) {
+    conv1d_symmetric_block<Ops, Anti>(in + i, kernel, k, out + i,
+                                      std::make_index_sequence<BLOCKS>{});
+  }
+  for (; i + W <= n_out; i += W) {
+    conv1d_symmetric_block<Ops, Anti>(in + i, kernel, k, out + i,
+                                      std::make_index_sequence<1>{});
+  }
+  for (; i < n_out; ++i) {
+    conv1d_symmetric_block<Scalar<T>, Anti>(in + i, kernel, k, out + i,
+                                            std::make_index_sequence<1>{});
+  }
+}
+
+template <typename T, ConvMode Mode, class Ops, bool Anti>
+void conv1d_symmetric(const std::span<const T> input,
+                      const std::span<const T> kernel, std::span<T> output) {
+  const size_t k = kernel.size();
+  const size_t n_out = conv1d_output_size<Mode>(input.size(), k);
+  if (output.size() < n_out) {
+    throw std::invalid_argument(
+        "Output span size is too small for the selected mode");
+  }
+
+  const T *in = input.data();
+  if constexpr (Mode != ConvMode::Valid) {
+    thread_local std::vector<T> padded;
+    padded.assign(n_out + k - 1, T{});
+    std::copy(input.begin(), input.end(),
+              padded.begin() + conv1d_pad<Mode>(k));
+    in = padded.data();
+  }
+  conv1d_symmetric_valid<Ops, Anti>(in, n_out, kernel.data(), k,
+                                    output.data());
+}
+
+} // namespace simd
+
+#if defined(__AVX2__)
+template <typename T, ConvMode Mode = ConvMode::Full>
+void conv1d_simd_avx2(const std::span<const T> input,
+                      const std::span<const T> kernel, std::span<T> output) {
+  simd::conv1d<T, Mode, simd::AVX2<T>>(input, kernel, output);
+}
+#endif
+
+#if defined(__AVX512F__)
+template <typename T, ConvMode Mode = ConvMode::Full>
+void conv1d_simd_avx512(const std::span<const T> input,
+                        const std::span<const T> kernel, std::span<T> output) {
+  simd::conv1d<T, Mode, simd::AVX512<T>>(input, kernel, output);
+}
+#endif
+
+#if defined(__ARM_NEON__)
+template <typename T, ConvMode Mode = ConvMode::Full>
+void conv1d_simd_neon(const std::span<const T> input,
+                      const std::span<const T> kernel, std::span<T> output) {
+  simd::conv1d<T, Mode, simd::NEON<T>>(input, kernel, output);
+}
+#endif
+
+/*
+Widest SIMD direct convolution available for the target
+*/
+template <typename T, ConvMode Mode = ConvMode::Full>
+void conv1d_simd(const std::span<const T> input,
+                 const std::span<const T> kernel, std::span<T> output) {
+#if defined(__AVX512F__)
+  conv1d_simd_avx512<T, Mode>(input, kernel, output);
+#elif defined(__AVX2__)
+  conv1d_simd_avx2<T, Mode>(input, kernel, output);
+#elif defined(__ARM_NEON__)
+  conv1d_simd_neon<T, Mode>(input, kernel, output);
+#else
+  conv1d_naive<T, Mode>(input, kernel, output);
+#endif
+}
+
+/*
+Linear-phase FIR kernels
+*/
+enum class KernelSymmetry {
+  None,          // general kernel
+  Symmetric,     // kernel[k - 1 - j] == kernel[j]
+  Antisymmetric, // kernel[k - 1 - j] == -kernel[j]
+};
+
+// Exact comparison: designs are expected to be symmetric by construction
+template <typename T>
+auto kernel_symmetry(const std::span<const T> kernel) -> KernelSymmetry {
+  const size_t k = kernel.size();
+  bool symmetric = true;
+  bool antisymmetric = true;
+  for (size_t j = 0; j < (k + 1) / 2; ++j) {
+    const T a = kernel[j];
+    const T b = kernel[k - 1 - j];
+    symmetric = symmetric && a == b;
+    antisymmetric = antisymmetric && a == -b;
+  }
+  if (symmetric) { return KernelSymmetry::Symmetric; }
+  if (antisymmetric) { return KernelSymmetry::Antisymmetric; }
+  return KernelSymmetry::None;
+}
+
+/*
+Direct SIMD convolution that halves the multiplies for linear-phase kernels
+by pre-adding mirrored input samples. Same semantics as conv1d_naive.
+A kernel with KernelSymmetry::None goes through conv1d_simd.
+The caller vouches for `symmetry`; it is not re-checked.
+*/
+template <typename T, ConvMode Mode = ConvMode::Full>
+void conv1d_linear_phase(const std::span<const T> input,
+                         const std::span<const T> kernel, std::span<T> output,
+                         KernelSymmetry symmetry) {
+  using Ops = simd::Native<T>;
+  switch (symmetry) {
+  case KernelSymmetry::Symmetric:
+    simd::conv1d_symmetric<T, Mode, Ops, false>(input, kernel, output);
+    break;
+  case KernelSymmetry::Antisymmetric:
+    simd::conv1d_symmetric<T, Mode, Ops, true>(input, kernel, output);
+    break;
+  default:
+    conv1d_simd<T, Mode>(input, kernel, output);
+  }
+}
+
+// Detects the symmetry of `kernel` (O(k)) on every call
+template <typename T, ConvMode Mode = ConvMode::Full>
+void conv1d_linear_phase(const std::span<const T> input,
+                         const std::span<const T> kernel,
+                         std::span<T> output) {
+  conv1d_linear_phase<T, Mode>(input, kernel, output,
+                               kernel_symmetry<T>(kernel));
+}
+
+/*
+Filter banks: apply n_kernels kernels of equal length to one input.
+
+`kernels` holds the kernels back to back (kernels[f * k + j]), the output of
+kernel f is written to output[f * n_out, (f + 1) * n_out). Same semantics as
+conv1d_naive per kernel. See also FFTFilterBank in conv1d_fft.hpp.
+*/
+
+// Direct SIMD: each input window is loaded once for a block of kernels
+template <typename T, ConvMode Mode = ConvMode::Full>
+void conv1d_bank_simd(const std::span<const T> input,
+                      const std::span<const T> kernels, size_t n_kernels,
+                      std::span<T> output) {
+  simd::conv1d_bank<T, Mode, simd::Native<T>>(input, kernels, n_kernels,
+                                               output);
+}
+
+// BLAS: one im2col matrix shared by all kernels, one GEMM
+template <typename T, ConvMode Mode = ConvMode::Full>
+void conv1d_bank_BLAS(const std::span<const T> input,
+                      const std::span<const T> kernels, size_t n_kernels,
+                      std::span<T> output) {
+  thread_local Conv1dBLASWorkspace<T> workspace;
+  workspace.template conv_bank<Mode>(input, kernels, n_kernels, output);
+}
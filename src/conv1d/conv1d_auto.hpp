@@ -0,0 +1,394 @@
+/**
+conv1d_auto: pick the fastest conv1d backend per (n, k, T, Mode) by timing
+them on first use, and persist the choices across runs.
+ */
+#pragma once
+
+#include "conv1d.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fftconv.hpp>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// NOLINTBEGIN(*-pointer-arithmetic, *-magic-numbers)
+
+enum class Conv1dBackend {
+  Naive,
+  SIMD,
+  Eigen,
+  BLAS,
+  KFR,
+  OpenCV,
+  FFTConv,
+  vDSP,
+  IPPDirect,
+  IPPFFT,
+};
+
+inline constexpr std::array<const char *, 10> CONV1D_BACKEND_NAMES{
+    "Naive",  "SIMD",    "Eigen", "BLAS",      "KFR",
+    "OpenCV", "FFTConv", "vDSP",  "IPPDirect", "IPPFFT",
+};
+
+inline auto to_string(Conv1dBackend backend) -> const char * {
+  return CONV1D_BACKEND_NAMES.at(static_cast<size_t>(backend));
+}
+
+// Backends compiled into this binary, in tuning order
+inline auto conv1d_available_backends() -> std::vector<Conv1dBackend> {
+  std::vector<Conv1dBackend> backends{
+      Conv1dBackend::Naive, Conv1dBackend::SIMD,   Conv1dBackend::Eigen,
+      Conv1dBackend::BLAS,  Conv1dBackend::KFR,    Conv1dBackend::OpenCV,
+      Conv1dBackend::FFTConv,
+  };
+#ifdef __APPLE__
+  backends.push_back(Conv1dBackend::vDSP);
+#endif
+#ifdef HAS_IPP
+  backends.push_back(Conv1dBackend::IPPDirect);
+  backends.push_back(Conv1dBackend::IPPFFT);
+#endif
+  return backends;
+}
+
+namespace detail {
+
+/*
+Adapters that give every backend conv1d_naive semantics for every mode.
+
+Eigen, vDSP, KFR and OpenCV are run in "valid" mode on a zero padded
+copy of the input. KFR, fftconv and IPP compute a true convolution, so they
+get the reversed kernel.
+*/
+
+// Offset of the Mode output inside the Full output
+template <ConvMode Mode> constexpr auto auto_full_offset(size_t k) -> size_t {
+  if constexpr (Mode == ConvMode::Full) {
+    return 0;
+  } else if constexpr (Mode == ConvMode::Same) {
+    return k - 1 - (k - 1) / 2;
+  } else {
+    return k - 1;
+  }
+}
+
+template <typename T>
+auto reversed_kernel(std::span<const T> kernel) -> std::span<const T> {
+  thread_local std::vector<T> rev;
+  rev.assign(kernel.rbegin(), kernel.rend());
+  return rev;
+}
+
+// Run a "valid" mode function on the input zero padded for Mode
+template <typename T, ConvMode Mode, typename Func>
+void conv1d_via_valid(std::span<const T> input, std::span<const T> kernel,
+                      std::span<T> output, Func valid_func) {
+  if constexpr (Mode == ConvMode::Valid) {
+    valid_func(input, kernel, output);
+  } else {
+    const size_t k = kernel.size();
+    const size_t n_out = conv1d_output_size<Mode>(input.size(), k);
+    const size_t pad = conv1d_pad<Mode>(k);
+
+    thread_local std::vector<T> padded;
+    padded.assign(n_out + k - 1, T{});
+    std::copy(input.begin(), input.end(), padded.begin() + pad);
+    valid_func(std::span<const T>(padded), kernel, output.first(n_out));
+  }
+}
+
+// Run a true "full" convolution function and slice out Mode
+template <typename T, ConvMode Mode, typename Func>
+void conv1d_via_full(std::span<const T> input, std::span<const T> kernel,
+                     std::span<T> output, Func full_func) {
+  const size_t k = kernel.size();
+  const auto kernel_rev = reversed_kernel<T>(kernel);
+  if constexpr (Mode == ConvMode::Full) {
+    full_func(input, kernel_rev, output.first(input.size() + k - 1));
+  } else {
+    thread_local std::vector<T> full;
+    full.resize(input.size() + k - 1);
+    full_func(input, kernel_rev, std::span<T>(full));
+
+    const size_t n_out = conv1d_output_size<Mode>(input.size(), k);
+    const auto first = full.begin() + auto_full_offset<Mode>(k);
+    std::copy(first, first + n_out, output.begin());
+  }
+}
+
+// filter_fir is causal: y[i] = sum_j h[j] x[i - j]
+template <typename T>
+void conv1d_valid_KFR(std::span<const T> input, std::span<const T> kernel,
+                      std::span<T> output) {
+  thread_local std::vector<T> causal;
+  causal.resize(input.size());
+  conv1d_KFR_fir<T>(input, reversed_kernel<T>(kernel), causal);
+  std::copy(causal.begin() + kernel.size() - 1, causal.end(), output.begin());
+}
+
+// filter2D correlates with the anchor at the kernel center
+template <typename T>
+void conv1d_valid_OpenCV(std::span<const T> input, std::span<const T> kernel,
+                         std::span<T> output) {
+  thread_local std::vector<T> centered;
+  centered.resize(input.size());
+  conv1d_OpenCV<T>(input, kernel, centered);
+  const auto first = centered.begin() + kernel.size() / 2;
+  std::copy(first, first + (input.size() - kernel.size() + 1),
+            output.begin());
+}
+
+template <typename T, ConvMode Mode>
+void conv1d_run_backend(Conv1dBackend backend, std::span<const T> input,
+                        std::span<const T> kernel, std::span<T> output) {
+  switch (backend) {
+  case Conv1dBackend::Naive:
+    conv1d_naive<T, Mode>(input, kernel, output);
+    break;
+  case Conv1dBackend::SIMD:
+    conv1d_simd<T, Mode>(input, kernel, output);
+    break;
+  case Conv1dBackend::Eigen:
+    conv1d_via_valid<T, Mode>(input, kernel, output, conv1d_eigen<T>);
+    break;
+  case Conv1dBackend::BLAS: {
+    thread_local Conv1dBLASWorkspace<T> workspace;
+    workspace.template conv<Mode>(input, kernel, output);
+    break;
+  }
+  case Conv1dBackend::KFR:
+    conv1d_via_valid<T, Mode>(input, kernel, output, conv1d_valid_KFR<T>);
+    break;
+  case Conv1dBackend::OpenCV:
+    conv1d_via_valid<T, Mode>(input, kernel, output, conv1d_valid_OpenCV<T>);
+    break;
+  case Conv1dBackend::FFTConv:
+    conv1d_via_full<T, Mode>(input, kernel, output,
+                             fftconv::oaconvolve_fftw<T>);
+    break;
+#ifdef __APPLE__
+  case Conv1dBackend::vDSP:
+    conv1d_via_valid<T, Mode>(input, kernel, output, conv1d_vDSP<T>);
+    break;
+#endif
+#ifdef HAS_IPP
+  case Conv1dBackend::IPPDirect:
+    conv1d_via_full<T, Mode>(input, kernel, output,
+                             conv1d_IPP<T, IppAlgType::ippAlgDirect>);
+    break;
+  case Conv1dBackend::IPPFFT:
+    conv1d_via_full<T, Mode>(input, kernel, output,
+                             conv1d_IPP<T, IppAlgType::ippAlgFFT>);
+    break;
+#endif
+  default:
+    throw std::invalid_argument(
+        std::string("conv1d backend not available: ") + to_string(backend));
+  }
+}
+
+struct AutotuneKey {
+  size_t n;
+  size_t k;
+  ConvMode mode;
+  bool is_double;
+
+  auto operator==(const AutotuneKey &other) const -> bool = default;
+};
+
+struct AutotuneKeyHash {
+  auto operator()(const AutotuneKey &key) const -> size_t {
+    size_t h = std::hash<size_t>{}(key.n);
+    h ^= std::hash<size_t>{}(key.k) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= static_cast<size_t>(key.mode) << 1 | size_t{key.is_double};
+    return h;
+  }
+};
+
+inline constexpr std::array<const char *, 3> CONV_MODE_NAMES{"full", "same",
+                                                              "valid"};
+
+} // namespace detail
+
+/**
+Process wide table of the fastest backend per (n, k, Mode, T).
+
+Text file format, one entry per line:
+  <f32|f64> <full|same|valid> <n> <k> <backend>
+*/
+struct Conv1dAutotuneTable {
+  std::mutex mutex;
+  std::unordered_map<detail::AutotuneKey, Conv1dBackend,
+                     detail::AutotuneKeyHash>
+      table;
+
+  static auto instance() -> Conv1dAutotuneTable & {
+    static Conv1dAutotuneTable tbl;
+    return tbl;
+  }
+
+  auto find(const detail::AutotuneKey &key) -> std::optional<Conv1dBackend> {
+    std::lock_guard lock(mutex);
+    if (auto it = table.find(key); it != table.end()) { return it->second; }
+    return std::nullopt;
+  }
+
+  void insert(const detail::AutotuneKey &key, Conv1dBackend backend) {
+    std::lock_guard lock(mutex);
+    table[key] = backend;
+  }
+
+  // Entries for backends not compiled into this binary are skipped
+  void import_from_file(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) { return; }
+
+    const auto available = conv1d_available_backends();
+    const auto index_of = [](const auto &names, const std::string &s) {
+      const auto it = std::find(names.begin(), names.end(), s);
+      return static_cast<size_t>(it - names.begin());
+    };
+
+    std::lock_guard lock(mutex);
+    std::string type;
+    std::string mode;
+    std::string name;
+    size_t n{};
+    size_t k{};
+    while (file >> type >> mode >> n >> k >> name) {
+      const auto mode_idx = index_of(detail::CONV_MODE_NAMES, mode);
+      const auto backend_idx = index_of(CONV1D_BACKEND_NAMES, name);
+      if ((type != "f32" && type != "f64") ||
+          mode_idx >= detail::CONV_MODE_NAMES.size() ||
+          backend_idx >= CONV1D_BACKEND_NAMES.size()) {
+        continue;
+      }
+      const auto backend = static_cast<Conv1dBackend>(backend_idx);
+      if (std::find(available.begin(), available.end(), backend) ==
+          available.end()) {
+        continue;
+      }
+      table[{n, k, static_cast<ConvMode>(mode_idx), type == "f64"}] = backend;
+    }
+  }
+
+  void export_to_file(const std::string &path) {
+    std::ofstream file(path);
+    if (!file) { return; }
+
+    std::lock_guard lock(mutex);
+    for (const auto &[key, backend] : table) {
+      file << (key.is_double ? "f64" : "f32") << ' '
+           << detail::CONV_MODE_NAMES.at(static_cast<size_t>(key.mode)) << ' '
+           << key.n << ' ' << key.k << ' ' << to_string(backend) << '\n';
+    }
+  }
+};
+
+/**
+Load the autotune table on construction and save it on destruction,
+like fftw::WisdomSetup does for FFTW wisdom.
+*/
+struct Conv1dAutotuneSetup {
+  std::string path;
+
+  explicit Conv1dAutotuneSetup(std::string path = ".conv1d_autotune")
+      : path(std::move(path)) {
+    Conv1dAutotuneTable::instance().import_from_file(this->path);
+  }
+  Conv1dAutotuneSetup(const Conv1dAutotuneSetup &) = delete;
+  Conv1dAutotuneSetup(Conv1dAutotuneSetup &&) = delete;
+  Conv1dAutotuneSetup &operator=(const Conv1dAutotuneSetup &) = delete;
+  Conv1dAutotuneSetup &operator=(Conv1dAutotuneSetup &&) = delete;
+  ~Conv1dAutotuneSetup() {
+    Conv1dAutotuneTable::instance().export_to_file(path);
+  }
+};
+
+/**
+Time every available backend on random data of shape (n, k) and return the
+fastest. Each backend gets one warm up call (plans, buffers) and is then
+scored by its best of `reps` runs.
+*/
+template <typename T, ConvMode Mode = ConvMode::Full>
+auto conv1d_autotune(size_t n, size_t k, int reps = 5) -> Conv1dBackend {
+  std::vector<T> input(n);
+  std::vector<T> kernel(k);
+  std::vector<T> output(conv1d_output_size<Mode>(n, k));
+  // Deterministic, non-trivial data
+  for (size_t i = 0; i < n; ++i) { input[i] = static_cast<T>((i * 7) % 13); }
+  for (size_t j = 0; j < k; ++j) { kernel[j] = static_cast<T>((j * 5) % 11); }
+
+  using clock = std::chrono::steady_clock;
+  auto best = Conv1dBackend::Naive;
+  auto best_time = clock::duration::max();
+
+  for (const auto backend : conv1d_available_backends()) {
+    detail::conv1d_run_backend<T, Mode>(backend, input, kernel, output);
+
+    auto elapsed = clock::duration::max();
+    for (int r = 0; r < reps; ++r) {
+      const auto start = clock::now();
+      detail::conv1d_run_backend<T, Mode>(backend, input, kernel, output);
+      elapsed = std::min(elapsed, clock::now() - start);
+    }
+
+    if (elapsed < best_time) {
+      best_time = elapsed;
+      best = backend;
+    }
+  }
+  return best;
+}
+
+// Backend conv1d_auto uses for this shape, tuning it on first use
+template <typename T, ConvMode Mode = ConvMode::Full>
+auto conv1d_auto_backend(size_t n, size_t k) -> Conv1dBackend {
+  const detail::AutotuneKey key{n, k, Mode, std::is_same_v<T, double>};
+  auto &table = Conv1dAutotuneTable::instance();
+  if (const auto backend = table.find(key)) { return *backend; }
+
+  // Serialize tuning so concurrent first calls don't skew each other's timing
+  static std::mutex tune_mutex;
+  std::lock_guard lock(tune_mutex);
+  if (const auto backend = table.find(key)) { return *backend; }
+
+  const auto backend = conv1d_autotune<T, Mode>(n, k);
+  table.insert(key, backend);
+  return backend;
+}
+
+/**
+conv1d with conv1d_naive semantics, dispatched to the fastest backend for
+this (input.size(), kernel.size(), T, Mode). The first call for a new shape
+tunes all backends (see conv1d_autotune).
+*/
+template <typename T, ConvMode Mode = ConvMode::Full>
+void conv1d_auto(const std::span<const T> input,
+                 const std::span<const T> kernel, std::span<T> output) {
+  if (kernel.empty() ||
+      (Mode == ConvMode::Valid && input.size() < kernel.size())) {
+    throw std::invalid_argument("Invalid input and kernel sizes");
+  }
+  if (output.size() <
+      conv1d_output_size<Mode>(input.size(), kernel.size())) {
+    throw std::invalid_argument(
+        "Output span size is too small for the selected mode");
+  }
+
+  const auto backend =
+      conv1d_auto_backend<T, Mode>(input.size(), kernel.size());
+  detail::conv1d_run_backend<T, Mode>(backend, input, kernel, output);
+}
+
+// NOLINTEND(*-pointer-arithmetic, *-magic-numbers)
@@ -0,0 +1,275 @@
+/**
+Batched conv1d: many channels (A-lines) filtered with one shared kernel
+ */
+#pragma once
+
+#include "conv1d.hpp"
+#include <algorithm>
+#include <opencv2/opencv.hpp>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// NOLINTBEGIN(*-pointer-arithmetic, *-magic-numbers)
+
+/**
+Strided 2D view over `channels` signals of `length` samples each.
+Element (i, c) (sample i of channel c) lives at
+data[i * sample_stride + c * channel_stride].
+
+Two layouts are common:
+  - channel major: each channel is contiguous (arma::Mat column per channel,
+    or a row-major image with one A-line per row), sample_stride == 1
+  - interleaved: each time sample holds all channels contiguously
+    (multi-channel ADC frames), channel_stride == 1
+*/
+template <typename T> struct StridedChannels {
+  T *data;
+  size_t length;
+  size_t channels;
+  size_t sample_stride;
+  size_t channel_stride;
+
+  // Channel c starts at data + c * pitch
+  static auto channel_major(T *data, size_t length, size_t channels,
+                            size_t pitch) -> StridedChannels {
+    return {data, length, channels, 1, pitch};
+  }
+  static auto channel_major(T *data, size_t length, size_t channels)
+      -> StridedChannels {
+    return channel_major(data, length, channels, length);
+  }
+
+  // Sample i starts at data + i * pitch
+  static auto interleaved(T *data, size_t length, size_t channels,
+                          size_t pitch) -> StridedChannels {
+    return {data, length, channels, pitch, 1};
+  }
+  static auto interleaved(T *data, size_t length, size_t channels)
+      -> StridedChannels {
+    return interleaved(data, length, channels, channels);
+  }
+
+  auto operator()(size_t i, size_t c) const -> T & {
+    return data[i * sample_stride + c * channel_stride];
+  }
+
+  // Read only view of the same data
+  operator StridedChannels<const T>() const { // NOLINT(*-explicit-*)
+    return {data, length, channels, sample_stride, channel_stride};
+  }
+};
+
+enum class BatchStrategy {
+  Auto,           // pick from the memory layout
+  AcrossTime,     // one channel at a time, SIMD lanes over samples
+  AcrossChannels, // one sample at a time, SIMD lanes over channels
+};
+
+namespace detail {
+
+/*
+One output row of `Blocks` channel vectors.
+`in` points at channel c of the first input row that overlaps the kernel,
+successive rows are `pitch` apart.
+*/
+template <class Ops, typename T, size_t... B>
+inline void conv1d_channels_block(const T *in, size_t pitch, const T *kernel,
+                                  size_t taps, T *out,
+                                  std::index_sequence<B...> /*blocks*/) {
+  using V = typename Ops::V;
+  constexpr size_t W = Ops::W;
+
+  V acc[sizeof...(B)]{ // NOLINT(*-avoid-c-arrays), see conv1d_block
+      (static_cast<void>(B), Ops::zero())...};
+  for (size_t j = 0; j < taps; ++j) {
+    const V kv = Ops::set1(kernel[j]);
+    const T *p = in + j * pitch;
+    ((acc[B] = Ops::fmadd(Ops::loadu(p + B * W), kv, acc[B])), ...);
+  }
+  (Ops::storeu(out + B * W, acc[B]), ...);
+}
+
+/*
+Output rows [row_begin, row_end) of an interleaved (channel_stride == 1)
+batch, vectorized across channels. Boundary rows only visit the taps that
+overlap the input, so no zero padded copy is needed.
+*/
+template <typename T, ConvMode Mode, class Ops, size_t Blocks>
+void conv1d_across_channels(const StridedChannels<const T> &in,
+                            std::span<const T> kernel,
+                            const StridedChannels<T> &out, size_t row_begin,
+                            size_t row_end) {
+  constexpr size_t W = Ops::W;
+  constexpr size_t step = W * Blocks;
+
+  const size_t n = in.length;
+  const size_t k = kernel.size();
+  const size_t pad = conv1d_pad<Mode>(k);
+  const size_t C = in.channels;
+
+  // Rows outermost: each output row sweeps its k input rows contiguously
+  // across channels, which the prefetcher handles well at any channel count.
+  for (size_t i = row_begin; i < row_end; ++i) {
+    // Taps j with 0 <= i + j - pad < n
+    const size_t j_lo = i < pad ? pad - i : 0;
+    const size_t j_hi = std::max(j_lo, std::min(k, n + pad - i));
+    const size_t taps = j_hi - j_lo;
+    const T *src = in.data + (i + j_lo - pad) * in.sample_stride;
+    const T *ker = kernel.data() + j_lo;
+    T *dst = out.data + i * out.sample_stride;
+
+    size_t c = 0;
+    for (; c + step <= C; c += step) {
+      conv1d_channels_block<Ops>(src + c, in.sample_stride, ker, taps,
+                                 dst + c, std::make_index_sequence<Blocks>{});
+    }
+    for (; c + W <= C; c += W) {
+      conv1d_channels_block<Ops>(src + c, in.sample_stride, ker, taps,
+                                 dst + c, std::make_index_sequence<1>{});
+    }
+    for (; c < C; ++c) {
+      conv1d_channels_block<simd::Scalar<T>>(src + c, in.sample_stride, ker,
+                                             taps, dst + c,
+                                             std::make_index_sequence<1>{});
+    }
+  }
+}
+
+// Channels [c_begin, c_end), each run through conv1d_simd
+template <typename T, ConvMode Mode>
+void conv1d_across_time(const StridedChannels<const T> &in,
+                        std::span<const T> kernel,
+                        const StridedChannels<T> &out, size_t c_begin,
+                        size_t c_end) {
+  const size_t n = in.length;
+  const size_t n_out = conv1d_output_size<Mode>(n, kernel.size());
+  const bool in_contig = in.sample_stride == 1;
+  const bool out_contig = out.sample_stride == 1;
+
+  // Gather/scatter buffers for strided channels
+  thread_local std::vector<T> in_buf;
+  thread_local std::vector<T> out_buf;
+  if (!in_contig) { in_buf.resize(n); }
+  if (!out_contig) { out_buf.resize(n_out); }
+
+  for (size_t c = c_begin; c < c_end; ++c) {
+    const T *src = in.data + c * in.channel_stride;
+    T *dst = out.data + c * out.channel_stride;
+
+    if (!in_contig) {
+      for (size_t i = 0; i < n; ++i) { in_buf[i] = src[i * in.sample_stride]; }
+      src = in_buf.data();
+    }
+
+    conv1d_simd<T, Mode>(std::span<const T>(src, n), kernel,
+                         out_contig ? std::span<T>(dst, n_out)
+                                    : std::span<T>(out_buf));
+
+    if (!out_contig) {
+      for (size_t i = 0; i < n_out; ++i) {
+        dst[i * out.sample_stride] = out_buf[i];
+      }
+    }
+  }
+}
+
+} // namespace detail
+
+/**
+Convolve every channel of `input` with the same kernel (conv1d_naive
+semantics, per channel) and write the results to the matching channels of
+`output`.
+
+With BatchStrategy::Auto, interleaved data with at least one SIMD vector of
+channels is vectorized across channels (every load is contiguous and the
+same kernel tap is broadcast once for many channels); everything else is
+vectorized across time per channel. Forcing a strategy on the "wrong" layout
+works but goes through gather/scatter copies.
+
+`parallel` splits the work over cv::parallel_for_ (channels for AcrossTime,
+output samples for AcrossChannels).
+*/
+template <typename T, ConvMode Mode = ConvMode::Full>
+void conv1d_batch(const StridedChannels<const T> &input,
+                  const std::span<const T> kernel,
+                  const StridedChannels<T> &output,
+                  BatchStrategy strategy = BatchStrategy::Auto,
+                  bool parallel = false) {
+  const size_t k = kernel.size();
+  if (k == 0) { throw std::invalid_argument("Kernel must not be empty"); }
+  if constexpr (Mode == ConvMode::Valid) {
+    if (input.length < k) {
+      throw std::invalid_argument("Input is shorter than the kernel");
+    }
+  }
+  if (output.channels != input.channels) {
+    throw std::invalid_argument("Input and output channel counts differ");
+  }
+  const size_t n_out = conv1d_output_size<Mode>(input.length, k);
+  if (output.length < n_out) {
+    throw std::invalid_argument(
+        "Output length is too small for the selected mode");
+  }
+
+  using Ops = simd::Native<T>;
+  const bool interleaved =
+      input.channel_stride == 1 && output.channel_stride == 1;
+
+  if (strategy == BatchStrategy::Auto) {
+    strategy = interleaved && input.channels >= Ops::W
+                   ? BatchStrategy::AcrossChannels
+                   : BatchStrategy::AcrossTime;
+  }
+
+  if (strategy == BatchStrategy::AcrossTime) {
+    const auto run = [&](const cv::Range &r) {
+      detail::conv1d_across_time<T, Mode>(input, kernel, output, r.start,
+                                          r.end);
+    };
+    if (parallel) {
+      cv::parallel_for_(cv::Range(0, static_cast<int>(input.channels)), run);
+    } else {
+      run(cv::Range(0, static_cast<int>(input.channels)));
+    }
+    return;
+  }
+
+  if (!interleaved) {
+    // Transpose into interleaved scratch, filter, transpose back
+    const size_t C = input.channels;
+    std::vector<T> in_buf(input.length * C);
+    std::vector<T> out_buf(n_out * C);
+    for (size_t c = 0; c < C; ++c) {
+      for (size_t i = 0; i < input.length; ++i) {
+        in_buf[i * C + c] = input(i, c);
+      }
+    }
+    conv1d_batch<T, Mode>(
+        StridedChannels<const T>::interleaved(in_buf.data(), input.length, C),
+        kernel, StridedChannels<T>::interleaved(out_buf.data(), n_out, C),
+        BatchStrategy::AcrossChannels, parallel);
+    for (size_t c = 0; c < C; ++c) {
+      for (size_t i = 0; i < n_out; ++i) {
+        output(i, c) = out_buf[i * C + c];
+      }
+    }
+    return;
+  }
+
+  // Narrower than simd::BLOCKS: each channel block streams its own k-row
+  // input stripe, so keep that stripe small enough to stay cached.
+  constexpr size_t Blocks = 4;
+  const auto run = [&](const cv::Range &r) {
+    detail::conv1d_across_channels<T, Mode, Ops, Blocks>(input, kernel, output,
+                                                         r.start, r.end);
+  };
+  if (parallel) {
+    cv::parallel_for_(cv::Range(0, static_cast<int>(n_out)), run);
+  } else {
+    run(cv::Range(0, static_cast<int>(n_out)));
+  }
+}
+
+// NOLINTEND(*-pointer-arithmetic, *-magic-numbers)
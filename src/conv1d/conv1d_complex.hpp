@@ -0,0 +1,535 @@
+/**
+Complex conv1d (I/Q and analytic signals), interleaved and split layouts
+ */
+#pragma once
+
+#include "conv1d.hpp"
+#include "conv1d_fft.hpp"
+#include "conv1d_fftw.hpp"
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// NOLINTBEGIN(*-pointer-arithmetic, *-magic-numbers)
+
+/**
+Split complex view: real and imaginary parts in separate arrays, e.g.
+{re.data(), im.data(), n} over two std::vector<T>.
+*/
+template <typename T> struct SplitComplex {
+  T *re;
+  T *im;
+  size_t size;
+
+  // Read only view of the same data
+  operator SplitComplex<const T>() const { // NOLINT(*-explicit-*)
+    return {re, im, size};
+  }
+};
+
+// fftw_complex arrays have the std::complex layout
+template <conv1d_fftw::Floating T>
+inline auto as_complex(conv1d_fftw::Complex<T> *data, size_t n)
+    -> std::span<std::complex<T>> {
+  return {reinterpret_cast<std::complex<T> *>(data), n};
+}
+template <conv1d_fftw::Floating T>
+inline auto as_complex(const conv1d_fftw::Complex<T> *data, size_t n)
+    -> std::span<const std::complex<T>> {
+  return {reinterpret_cast<const std::complex<T> *>(data), n};
+}
+
+namespace simd {
+
+/*
+Swap the real and imaginary lanes of interleaved complex vectors,
+(re0, im0, re1, im1, ...) -> (im0, re0, im1, re1, ...).
+Only defined for Ops with at least one complex sample per vector.
+*/
+template <class Ops> struct SwapPairs;
+
+#if defined(__AVX2__)
+template <> struct SwapPairs<AVX2<float>> {
+  static auto apply(__m256 v) -> __m256 { return _mm256_permute_ps(v, 0xB1); }
+};
+template <> struct SwapPairs<AVX2<double>> {
+  static auto apply(__m256d v) -> __m256d {
+    return _mm256_permute_pd(v, 0b0101);
+  }
+};
+#endif
+
+#if defined(__AVX512F__)
+template <> struct SwapPairs<AVX512<float>> {
+  static auto apply(__m512 v) -> __m512 { return _mm512_permute_ps(v, 0xB1); }
+};
+template <> struct SwapPairs<AVX512<double>> {
+  static auto apply(__m512d v) -> __m512d {
+    return _mm512_permute_pd(v, 0x55);
+  }
+};
+#endif
+
+#if defined(__ARM_NEON__)
+template <> struct SwapPairs<NEON<float>> {
+  static auto apply(float32x4_t v) -> float32x4_t { return vrev64q_f32(v); }
+};
+template <> struct SwapPairs<NEON<double>> {
+  static auto apply(float64x2_t v) -> float64x2_t {
+    return vextq_f64(v, v, 1);
+  }
+};
+#endif
+
+/*
+Interleaved complex x complex "valid" block, W / 2 complex outputs per
+vector. Per tap the input vector is multiplied by the broadcast real and
+imaginary parts of the tap into two accumulators,
+  acc_r = sum (xr kr, xi kr),  acc_i = sum (xr ki, xi ki),
+and the store recombines them as acc_r + (-1, 1) * swap(acc_i).
+*/
+template <class Ops, typename T, size_t... B>
+inline void conv1d_cx_block(const T *in, const T *kr, const T *ki, size_t k,
+                            T *out, std::index_sequence<B...> /*blocks*/) {
+  using V = typename Ops::V;
+  constexpr size_t W = Ops::W;
+
+  // NOLINTBEGIN(*-avoid-c-arrays): std::array<V> drops V's vector attributes
+  V acc_r[sizeof...(B)]{(static_cast<void>(B), Ops::zero())...};
+  V acc_i[sizeof...(B)]{(static_cast<void>(B), Ops::zero())...};
+  // NOLINTEND(*-avoid-c-arrays)
+  for (size_t j = 0; j < k; ++j) {
+    const V vr = Ops::set1(kr[j]);
+    const V vi = Ops::set1(ki[j]);
+    const T *p = in + 2 * j;
+    const auto step = [&](size_t b) {
+      const V x = Ops::loadu(p + b * W);
+      acc_r[b] = Ops::fmadd(x, vr, acc_r[b]);
+      acc_i[b] = Ops::fmadd(x, vi, acc_i[b]);
+    };
+    (step(B), ...);
+  }
+
+  constexpr auto signs = [] {
+    std::array<T, W> s{};
+    for (size_t l = 0; l < W; ++l) { s[l] = l % 2 == 0 ? T{-1} : T{1}; }
+    return s;
+  }();
+  const V sign = Ops::loadu(signs.data());
+  (Ops::storeu(out + B * W,
+               Ops::fmadd(SwapPairs<Ops>::apply(acc_i[B]), sign, acc_r[B])),
+   ...);
+}
+
+// `in` holds n_out + k - 1 interleaved complex samples
+template <class Ops, size_t Blocks, typename T>
+void conv1d_cx_valid(const T *in, size_t n_out, const T *kr, const T *ki,
+                     size_t k, T *out) {
+  constexpr size_t W = Ops::W;
+  const size_t n_real = 2 * n_out;
+
+  size_t r = 0;
+  if constexpr (W >= 2) {
+    for (; r + W * Blocks <= n_real; r += W * Blocks) {
+      conv1d_cx_block<Ops>(in + r, kr, ki, k, out + r,
+                           std::make_index_sequence<Blocks>{});
+    }
+    for (; r + W <= n_real; r += W) {
+      conv1d_cx_block<Ops>(in + r, kr, ki, k, out + r,
+                           std::make_index_sequence<1>{});
+    }
+  }
+
+  // Remaining complex samples
+  for (; r < n_real; r += 2) {
+    T re{};
+    T im{};
+    for (size_t j = 0; j < k; ++j) {
+      const T xr = in[r + 2 * j];
+      const T xi = in[r + 2 * j + 1];
+      re += xr * kr[j] - xi * ki[j];
+      im += xr * ki[j] + xi * kr[j];
+    }
+    out[r] = re;
+    out[r + 1] = im;
+  }
+}
+
+/*
+Interleaved complex x real "valid" kernel: out[r] = sum_j in[r + 2 j] k[j]
+over the 2 n_out interleaved reals, i.e. conv1d_block with a tap stride of
+one complex sample. Any W works, real and imaginary lanes are independent.
+*/
+template <class Ops, typename T, size_t... B>
+inline void conv1d_cx_real_block(const T *in, const T *kernel, size_t k,
+                                 T *out, std::index_sequence<B...> /*blocks*/) {
+  using V = typename Ops::V;
+  constexpr size_t W = Ops::W;
+
+  V acc[sizeof...(B)]{ // NOLINT(*-avoid-c-arrays), see conv1d_cx_block
+      (static_cast<void>(B), Ops::zero())...};
+  for (size_t j = 0; j < k; ++j) {
+    const V kv = Ops::set1(kernel[j]);
+    const T *p = in + 2 * j;
+    ((acc[B] = Ops::fmadd(Ops::loadu(p + B * W), kv, acc[B])), ...);
+  }
+  (Ops::storeu(out + B * W, acc[B]), ...);
+}
+
+template <class Ops, size_t Blocks, typename T>
+void conv1d_cx_real_valid(const T *in, size_t n_out, const T *kernel,
+                          size_t k, T *out) {
+  constexpr size_t W = Ops::W;
+  const size_t n_real = 2 * n_out;
+
+  size_t r = 0;
+  for (; r + W * Blocks <= n_real; r += W * Blocks) {
+    conv1d_cx_real_block<Ops>(in + r, kernel, k, out + r,
+                              std::make_index_sequence<Blocks>{});
+  }
+  for (; r + W <= n_real; r += W) {
+    conv1d_cx_real_block<Ops>(in + r, kernel, k, out + r,
+                              std::make_index_sequence<1>{});
+  }
+  for (; r < n_real; ++r) {
+    T acc{};
+    for (size_t j = 0; j < k; ++j) { acc += in[r + 2 * j] * kernel[j]; }
+    out[r] = acc;
+  }
+}
+
+/*
+Split complex x complex "valid" block, W complex outputs per vector.
+Real and imaginary input vectors are loaded once per tap and feed both
+accumulators; `nki` holds the negated imaginary taps so all four updates
+are FMAs.
+*/
+template <class Ops, typename T, size_t... B>
+inline void conv1d_split_block(const T *in_re, const T *in_im, const T *kr,
+                               const T *ki, const T *nki, size_t k, T *out_re,
+                               T *out_im,
+                               std::index_sequence<B...> /*blocks*/) {
+  using V = typename Ops::V;
+  constexpr size_t W = Ops::W;
+
+  // NOLINTBEGIN(*-avoid-c-arrays), see conv1d_cx_block
+  V acc_r[sizeof...(B)]{(static_cast<void>(B), Ops::zero())...};
+  V acc_i[sizeof...(B)]{(static_cast<void>(B), Ops::zero())...};
+  // NOLINTEND(*-avoid-c-arrays)
+  for (size_t j = 0; j < k; ++j) {
+    const V vr = Ops::set1(kr[j]);
+    const V vi = Ops::set1(ki[j]);
+    const V vni = Ops::set1(nki[j]);
+    const auto step = [&](size_t b) {
+      const V xr = Ops::loadu(in_re + j + b * W);
+      const V xi = Ops::loadu(in_im + j + b * W);
+      acc_r[b] = Ops::fmadd(xi, vni, Ops::fmadd(xr, vr, acc_r[b]));
+      acc_i[b] = Ops::fmadd(xi, vr, Ops::fmadd(xr, vi, acc_i[b]));
+    };
+    (step(B), ...);
+  }
+  (Ops::storeu(out_re + B * W, acc_r[B]), ...);
+  (Ops::storeu(out_im + B * W, acc_i[B]), ...);
+}
+
+template <class Ops, size_t Blocks, typename T>
+void conv1d_split_valid(const T *in_re, const T *in_im, size_t n_out,
+                        const T *kr, const T *ki, const T *nki, size_t k,
+                        T *out_re, T *out_im) {
+  constexpr size_t W = Ops::W;
+
+  size_t i = 0;
+  for (; i + W * Blocks <= n_out; i += W * Blocks) {
+    conv1d_split_block<Ops>(in_re + i, in_im + i, kr, ki, nki, k, out_re + i,
+                            out_im + i, std::make_index_sequence<Blocks>{});
+  }
+  for (; i + W <= n_out; i += W) {
+    conv1d_split_block<Ops>(in_re + i, in_im + i, kr, ki, nki, k, out_re + i,
+                            out_im + i, std::make_index_sequence<1>{});
+  }
+  for (; i < n_out; ++i) {
+    T re{};
+    T im{};
+    for (size_t j = 0; j < k; ++j) {
+      re += in_re[i + j] * kr[j] - in_im[i + j] * ki[j];
+      im += in_re[i + j] * ki[j] + in_im[i + j] * kr[j];
+    }
+    out_re[i] = re;
+    out_im[i] = im;
+  }
+}
+
+// Two accumulators per block, half the real kernels' BLOCKS keeps them in
+// registers on AVX2
+inline constexpr size_t CX_BLOCKS = BLOCKS / 2;
+
+} // namespace simd
+
+namespace detail {
+
+template <ConvMode Mode>
+void check_conv1d_sizes(size_t n, size_t k, size_t output_size) {
+  if (k == 0) { throw std::invalid_argument("Kernel must not be empty"); }
+  if constexpr (Mode == ConvMode::Valid) {
+    if (n < k) {
+      throw std::invalid_argument("Input is shorter than the kernel");
+    }
+  }
+  if (output_size < conv1d_output_size<Mode>(n, k)) {
+    throw std::invalid_argument(
+        "Output span size is too small for the selected mode");
+  }
+}
+
+// Zero padded copy for Full/Same, the input itself for Valid
+template <ConvMode Mode, typename S>
+auto conv1d_padded_input(std::span<const S> input, size_t k) -> const S * {
+  if constexpr (Mode == ConvMode::Valid) {
+    return input.data();
+  } else {
+    thread_local std::vector<S> padded;
+    padded.assign(conv1d_output_size<Mode>(input.size(), k) + k - 1, S{});
+    std::copy(input.begin(), input.end(),
+              padded.begin() + conv1d_pad<Mode>(k));
+    return padded.data();
+  }
+}
+
+} // namespace detail
+
+/**
+Direct SIMD convolution of interleaved complex signals
+(std::complex<T> or conv1d_fftw::Complex<T> through as_complex), conv1d_naive
+semantics: out[i] = sum_j in[i + j - pad] * kernel[j], no conjugation.
+*/
+template <conv1d_fftw::Floating T, ConvMode Mode = ConvMode::Full>
+void conv1d_complex(const std::span<const std::complex<T>> input,
+                    const std::span<const std::complex<T>> kernel,
+                    std::span<std::complex<T>> output) {
+  const size_t k = kernel.size();
+  detail::check_conv1d_sizes<Mode>(input.size(), k, output.size());
+  const size_t n_out = conv1d_output_size<Mode>(input.size(), k);
+
+  thread_local std::vector<T> kr;
+  thread_local std::vector<T> ki;
+  kr.resize(k);
+  ki.resize(k);
+  for (size_t j = 0; j < k; ++j) {
+    kr[j] = kernel[j].real();
+    ki[j] = kernel[j].imag();
+  }
+
+  const auto *in = reinterpret_cast<const T *>(
+      detail::conv1d_padded_input<Mode>(input, k));
+  simd::conv1d_cx_valid<simd::Native<T>, simd::CX_BLOCKS>(
+      in, n_out, kr.data(), ki.data(), k,
+      reinterpret_cast<T *>(output.data()));
+}
+
+// Interleaved complex signal, real kernel: filters I and Q independently
+template <conv1d_fftw::Floating T, ConvMode Mode = ConvMode::Full>
+void conv1d_complex(const std::span<const std::complex<T>> input,
+                    const std::span<const T> kernel,
+                    std::span<std::complex<T>> output) {
+  const size_t k = kernel.size();
+  detail::check_conv1d_sizes<Mode>(input.size(), k, output.size());
+  const size_t n_out = conv1d_output_size<Mode>(input.size(), k);
+
+  const auto *in = reinterpret_cast<const T *>(
+      detail::conv1d_padded_input<Mode>(input, k));
+  simd::conv1d_cx_real_valid<simd::Native<T>, simd::BLOCKS>(
+      in, n_out, kernel.data(), k, reinterpret_cast<T *>(output.data()));
+}
+
+// Split complex signal and kernel
+template <conv1d_fftw::Floating T, ConvMode Mode = ConvMode::Full>
+void conv1d_complex(const SplitComplex<const T> input,
+                    const SplitComplex<const T> kernel,
+                    const SplitComplex<T> output) {
+  const size_t k = kernel.size;
+  detail::check_conv1d_sizes<Mode>(input.size, k, output.size);
+  const size_t n_out = conv1d_output_size<Mode>(input.size, k);
+
+  thread_local std::vector<T> nki;
+  nki.resize(k);
+  for (size_t j = 0; j < k; ++j) { nki[j] = -kernel.im[j]; }
+
+  // Both parts need their own padded copy
+  const T *in_re = input.re;
+  const T *in_im = input.im;
+  if constexpr (Mode != ConvMode::Valid) {
+    const size_t len = n_out + k - 1;
+    const size_t pad = conv1d_pad<Mode>(k);
+    thread_local std::vector<T> padded;
+    padded.assign(2 * len, T{});
+    std::copy_n(input.re, input.size, padded.begin() + pad);
+    std::copy_n(input.im, input.size, padded.begin() + len + pad);
+    in_re = padded.data();
+    in_im = padded.data() + len;
+  }
+
+  simd::conv1d_split_valid<simd::Native<T>, simd::CX_BLOCKS>(
+      in_re, in_im, n_out, kernel.re, kernel.im, nki.data(), k, output.re,
+      output.im);
+}
+
+// Split complex signal, real kernel
+template <conv1d_fftw::Floating T, ConvMode Mode = ConvMode::Full>
+void conv1d_complex(const SplitComplex<const T> input,
+                    const std::span<const T> kernel,
+                    const SplitComplex<T> output) {
+  const size_t k = kernel.size();
+  detail::check_conv1d_sizes<Mode>(input.size, k, output.size);
+  const size_t n_out = conv1d_output_size<Mode>(input.size, k);
+
+  conv1d_simd<T, Mode>({input.re, input.size}, kernel, {output.re, n_out});
+  conv1d_simd<T, Mode>({input.im, input.size}, kernel, {output.im, n_out});
+}
+
+/**
+Overlap-save FFT convolution of complex signals with a fixed complex (or
+real) kernel, conv1d_naive semantics, for kernels long enough that the
+direct conv1d_complex loses.
+
+The spectrum of the reversed kernel is computed once, pre-scaled by 1/nfft,
+at the FFT size optimal_fft_size picks for inputs of `n` samples. Plans and
+buffers come from the per-thread conv1d_fftw::EngineDFT1D cache. Split
+inputs are staged through the interleaved FFT buffer.
+*/
+template <conv1d_fftw::Floating T> struct ComplexFFTConvolver {
+  using Cx = conv1d_fftw::Complex<T>;
+
+  size_t k;
+  size_t nfft;
+  Cx *spectrum;
+
+  ComplexFFTConvolver(std::span<const std::complex<T>> kernel, size_t n)
+      : k(kernel.size()), nfft(optimal_fft_size(n, kernel.size())),
+        spectrum(nullptr) {
+    init([&](size_t j) { return kernel[j]; });
+  }
+  ComplexFFTConvolver(std::span<const T> kernel, size_t n)
+      : k(kernel.size()), nfft(optimal_fft_size(n, kernel.size())),
+        spectrum(nullptr) {
+    init([&](size_t j) { return std::complex<T>(kernel[j]); });
+  }
+  ComplexFFTConvolver(const ComplexFFTConvolver &) = delete;
+  ComplexFFTConvolver(ComplexFFTConvolver &&) = delete;
+  ComplexFFTConvolver &operator=(const ComplexFFTConvolver &) = delete;
+  ComplexFFTConvolver &operator=(ComplexFFTConvolver &&) = delete;
+  ~ComplexFFTConvolver() noexcept {
+    if (spectrum) conv1d_fftw::free<T>(spectrum);
+  }
+
+  [[nodiscard]] auto fft_size() const -> size_t { return nfft; }
+  [[nodiscard]] auto block_size() const -> size_t { return nfft - k + 1; }
+
+  template <ConvMode Mode = ConvMode::Full>
+  void conv(std::span<const std::complex<T>> input,
+            std::span<std::complex<T>> output) {
+    detail::check_conv1d_sizes<Mode>(input.size(), k, output.size());
+    run<Mode>(
+        input.size(),
+        [&](size_t src, size_t len, Cx *dst) {
+          std::copy_n(input.data() + src, len,
+                      reinterpret_cast<std::complex<T> *>(dst));
+        },
+        [&](const Cx *src, size_t dst, size_t len) {
+          std::copy_n(reinterpret_cast<const std::complex<T> *>(src), len,
+                      output.data() + dst);
+        });
+  }
+
+  template <ConvMode Mode = ConvMode::Full>
+  void conv(const SplitComplex<const T> input, const SplitComplex<T> output) {
+    detail::check_conv1d_sizes<Mode>(input.size, k, output.size);
+    run<Mode>(
+        input.size,
+        [&](size_t src, size_t len, Cx *dst) {
+          for (size_t i = 0; i < len; ++i) {
+            dst[i][0] = input.re[src + i];
+            dst[i][1] = input.im[src + i];
+          }
+        },
+        [&](const Cx *src, size_t dst, size_t len) {
+          for (size_t i = 0; i < len; ++i) {
+            output.re[dst + i] = src[i][0];
+            output.im[dst + i] = src[i][1];
+          }
+        });
+  }
+
+private:
+  template <typename KernelAt> void init(KernelAt kernel_at) {
+    spectrum = conv1d_fftw::alloc_complex<T>(nfft);
+
+    auto &engine = conv1d_fftw::EngineDFT1D<T>::get(nfft);
+    auto &buf = engine.buf;
+    std::fill_n(&buf.in[0][0], 2 * nfft, T{});
+    for (size_t j = 0; j < k; ++j) {
+      const auto h = kernel_at(k - 1 - j);
+      buf.in[j][0] = h.real();
+      buf.in[j][1] = h.imag();
+    }
+    engine.forward();
+
+    const T fct = static_cast<T>(1. / nfft);
+    for (size_t i = 0; i < nfft; ++i) {
+      spectrum[i][0] = buf.out[i][0] * fct;
+      spectrum[i][1] = buf.out[i][1] * fct;
+    }
+  }
+
+  // load(src, len, dst) copies input [src, src + len) into the FFT buffer,
+  // store(src, dst, len) copies len outputs to output [dst, dst + len)
+  template <ConvMode Mode, typename Load, typename Store>
+  void run(size_t n, Load load, Store store) {
+    auto &engine = conv1d_fftw::EngineDFT1D<T>::get(nfft);
+    auto &buf = engine.buf;
+    const size_t n_out = conv1d_output_size<Mode>(n, k);
+    const size_t L = block_size();
+
+    // Output o is sample o + offset of the causal convolution with the
+    // reversed kernel, which needs inputs [o + offset - (k - 1), o + offset]
+    const size_t offset = k - 1 - conv1d_pad<Mode>(k);
+
+    for (size_t o = 0; o < n_out; o += L) {
+      const size_t len = std::min(L, n_out - o);
+
+      // Window start in input coordinates, may be negative (zero padding)
+      const auto start = static_cast<std::ptrdiff_t>(o + offset) -
+                         static_cast<std::ptrdiff_t>(k - 1);
+      const auto lo = static_cast<size_t>(std::max<std::ptrdiff_t>(0, -start));
+      const auto hi = static_cast<size_t>(std::clamp<std::ptrdiff_t>(
+          static_cast<std::ptrdiff_t>(n) - start, 0,
+          static_cast<std::ptrdiff_t>(len + k - 1)));
+
+      std::fill_n(&buf.in[0][0], 2 * nfft, T{});
+      if (lo < hi) {
+        load(static_cast<size_t>(start + static_cast<std::ptrdiff_t>(lo)),
+             hi - lo, buf.in + lo);
+      }
+      engine.forward();
+      multiply_spectrum<T>(buf.out, spectrum, nfft);
+      engine.backward();
+
+      // The first k - 1 samples are corrupted by circular wrap-around
+      store(buf.in + (k - 1), o, len);
+    }
+  }
+};
+
+// NOLINTEND(*-pointer-arithmetic, *-magic-numbers)
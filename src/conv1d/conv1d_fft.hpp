@@ -0,0 +1,312 @@
+/**
+FFT-domain conv1d building blocks on top of FFTW (conv1d_fftw.hpp)
+ */
+#pragma once
+
+#include "conv1d.hpp"
+#include "conv1d_fftw.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+// NOLINTBEGIN(*-pointer-arithmetic, *-magic-numbers)
+
+// Smallest power of 2 >= n
+inline auto next_pow2(size_t n) -> size_t {
+  size_t p = 1;
+  while (p < n) { p <<= 1; }
+  return p;
+}
+
+/*
+FFT size that minimizes the modeled cost of overlap-save filtering an input
+of n samples with a kernel of k taps: ceil((n + k - 1) / (nfft - k + 1))
+blocks, each costing a forward and an inverse real FFT (~nfft log2 nfft)
+plus the spectrum multiply and copies (~nfft). Power of 2 sizes only, from
+2k (block of at least k + 1 outputs) up to one block covering the input.
+Throws std::invalid_argument on an empty kernel.
+*/
+inline auto optimal_fft_size(size_t n, size_t k) -> size_t {
+  if (k == 0) { throw std::invalid_argument("Kernel must not be empty"); }
+  const size_t n_out = n + k - 1;
+  const size_t max_size = next_pow2(n_out);
+
+  size_t best = max_size;
+  double best_cost = std::numeric_limits<double>::max();
+  for (size_t nfft = std::min(next_pow2(2 * k), max_size); nfft <= max_size;
+       nfft <<= 1) {
+    const size_t block = nfft - k + 1;
+    const auto blocks = static_cast<double>((n_out + block - 1) / block);
+    const auto sz = static_cast<double>(nfft);
+    const double cost = blocks * (2 * sz * std::log2(sz) + 4 * sz);
+    if (cost < best_cost) {
+      best_cost = cost;
+      best = nfft;
+    }
+  }
+  return best;
+}
+
+// a[i] *= b[i] for fftw complex arrays
+template <conv1d_fftw::Floating T>
+inline void multiply_spectrum(conv1d_fftw::Complex<T> *a,
+                              conv1d_fftw::Complex<T> const *b, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    const auto re = a[i][0] * b[i][0] - a[i][1] * b[i][1];
+    const auto im = a[i][0] * b[i][1] + a[i][1] * b[i][0];
+    a[i][0] = re;
+    a[i][1] = im;
+  }
+}
+
+// out[i] = a[i] * b[i] for fftw complex arrays
+template <conv1d_fftw::Floating T>
+inline void multiply_spectrum(conv1d_fftw::Complex<T> *out,
+                              conv1d_fftw::Complex<T> const *a,
+                              conv1d_fftw::Complex<T> const *b, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    const auto re = a[i][0] * b[i][0] - a[i][1] * b[i][1];
+    const auto im = a[i][0] * b[i][1] + a[i][1] * b[i][0];
+    out[i][0] = re;
+    out[i][1] = im;
+  }
+}
+
+// acc[i] += a[i] * b[i] for fftw complex arrays
+template <conv1d_fftw::Floating T>
+inline void multiply_accumulate_spectrum(conv1d_fftw::Complex<T> *acc,
+                                         conv1d_fftw::Complex<T> const *a,
+                                         conv1d_fftw::Complex<T> const *b,
+                                         size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    acc[i][0] += a[i][0] * b[i][0] - a[i][1] * b[i][1];
+    acc[i][1] += a[i][0] * b[i][1] + a[i][1] * b[i][0];
+  }
+}
+
+/**
+Overlap-save block convolution with a precomputed kernel spectrum.
+
+Every `process` call takes the last `k - 1` input samples (history) and up to
+`block_size()` new samples, and produces one output per new sample, i.e.
+y[i] = sum_j kernel[j] * x[i - j]. The spectrum is pre-scaled by 1/nfft so
+the inverse FFT output needs no extra normalization pass.
+
+FFT plans and buffers come from the per-thread `conv1d_fftw::EngineR2C1D`
+cache.
+*/
+template <conv1d_fftw::Floating T> struct OverlapSave {
+  using Cx = conv1d_fftw::Complex<T>;
+
+  size_t k;
+  size_t nfft;
+  Cx *kernel_spectrum;
+
+  OverlapSave(std::span<const T> kernel, size_t nfft)
+      : k(kernel.size()), nfft(nfft),
+        kernel_spectrum(conv1d_fftw::alloc_complex<T>(nfft / 2 + 1)) {
+    assert(k > 0 && nfft >= k);
+
+    auto &engine = conv1d_fftw::EngineR2C1D<T>::get(nfft);
+    auto &buf = engine.buf;
+    std::copy(kernel.begin(), kernel.end(), buf.in);
+    std::fill(buf.in + k, buf.in + nfft, T{});
+    engine.forward();
+
+    const T fct = static_cast<T>(1. / nfft);
+    for (size_t i = 0; i < nfft / 2 + 1; ++i) {
+      kernel_spectrum[i][0] = buf.out[i][0] * fct;
+      kernel_spectrum[i][1] = buf.out[i][1] * fct;
+    }
+  }
+  OverlapSave(const OverlapSave &) = delete;
+  OverlapSave(OverlapSave &&) = delete;
+  OverlapSave &operator=(const OverlapSave &) = delete;
+  OverlapSave &operator=(OverlapSave &&) = delete;
+  ~OverlapSave() noexcept {
+    if (kernel_spectrum) conv1d_fftw::free<T>(kernel_spectrum);
+  }
+
+  // Number of new samples that fit in one FFT block
+  [[nodiscard]] auto block_size() const -> size_t { return nfft - k + 1; }
+
+  // `history` must hold k - 1 samples, input.size() <= block_size()
+  void process(std::span<const T> history, std::span<const T> input,
+               T *output) const {
+    assert(history.size() == k - 1);
+    assert(input.size() <= block_size());
+
+    auto &engine = conv1d_fftw::EngineR2C1D<T>::get(nfft);
+    auto &buf = engine.buf;
+
+    const size_t len = history.size() + input.size();
+    std::copy(history.begin(), history.end(), buf.in);
+    std::copy(input.begin(), input.end(), buf.in + history.size());
+    std::fill(buf.in + len, buf.in + nfft, T{});
+
+    engine.forward();
+    multiply_spectrum<T>(buf.out, kernel_spectrum, nfft / 2 + 1);
+    engine.backward();
+
+    // The first k - 1 samples are corrupted by circular wrap-around
+    std::copy(buf.in + history.size(), buf.in + len, output);
+  }
+};
+
+/**
+Filter bank convolution sharing one forward FFT per input block.
+
+Overlap-save over the input: every block of `block_size()` outputs costs one
+forward FFT of the input window, then one spectrum multiply and inverse FFT
+per kernel. The kernel spectra are computed once from the reversed kernels
+(so results follow conv1d_naive semantics) and pre-scaled by 1/nfft.
+
+`kernels` holds n_kernels kernels of equal length back to back; the output
+of kernel f goes to output[f * n_out, (f + 1) * n_out), as with
+conv1d_bank_simd and conv1d_bank_BLAS.
+*/
+template <conv1d_fftw::Floating T> struct FFTFilterBank {
+  using Cx = conv1d_fftw::Complex<T>;
+
+  size_t n_kernels;
+  size_t k;
+  size_t nfft;
+  Cx *spectra;        // n_kernels * (nfft / 2 + 1)
+  Cx *input_spectrum; // nfft / 2 + 1
+
+  // nfft == 0 picks next_pow2(4 * k)
+  FFTFilterBank(std::span<const T> kernels, size_t n_kernels, size_t nfft = 0)
+      : n_kernels(n_kernels),
+        k(n_kernels == 0 ? 0 : kernels.size() / n_kernels),
+        nfft(nfft == 0 ? next_pow2(4 * k) : nfft), spectra(nullptr),
+        input_spectrum(nullptr) {
+    if (n_kernels == 0 || k == 0 || kernels.size() % n_kernels != 0) {
+      throw std::invalid_argument(
+          "Kernel bank size is not a multiple of the number of kernels");
+    }
+    if (this->nfft < k) {
+      throw std::invalid_argument("FFT size is smaller than the kernel");
+    }
+
+    const size_t n_cx = this->nfft / 2 + 1;
+    spectra = conv1d_fftw::alloc_complex<T>(n_kernels * n_cx);
+    input_spectrum = conv1d_fftw::alloc_complex<T>(n_cx);
+
+    auto &engine = conv1d_fftw::EngineR2C1D<T>::get(this->nfft);
+    auto &buf = engine.buf;
+    const T fct = static_cast<T>(1. / this->nfft);
+    for (size_t f = 0; f < n_kernels; ++f) {
+      const auto kernel = kernels.subspan(f * k, k);
+      std::copy(kernel.rbegin(), kernel.rend(), buf.in);
+      std::fill(buf.in + k, buf.in + this->nfft, T{});
+      engine.forward();
+
+      Cx *dst = spectra + f * n_cx;
+      for (size_t i = 0; i < n_cx; ++i) {
+        dst[i][0] = buf.out[i][0] * fct;
+        dst[i][1] = buf.out[i][1] * fct;
+      }
+    }
+  }
+  FFTFilterBank(const FFTFilterBank &) = delete;
+  FFTFilterBank(FFTFilterBank &&) = delete;
+  FFTFilterBank &operator=(const FFTFilterBank &) = delete;
+  FFTFilterBank &operator=(FFTFilterBank &&) = delete;
+  ~FFTFilterBank() noexcept {
+    if (spectra) conv1d_fftw::free<T>(spectra);
+    if (input_spectrum) conv1d_fftw::free<T>(input_spectrum);
+  }
+
+  // Outputs per kernel produced by one forward FFT
+  [[nodiscard]] auto block_size() const -> size_t { return nfft - k + 1; }
+
+  template <ConvMode Mode = ConvMode::Full>
+  void conv(std::span<const T> input, std::span<T> output) {
+    const size_t n = input.size();
+    if (Mode == ConvMode::Valid && n < k) {
+      throw std::invalid_argument("Invalid input and kernel sizes");
+    }
+    const size_t n_out = conv1d_output_size<Mode>(n, k);
+    if (output.size() < n_out * n_kernels) {
+      throw std::invalid_argument(
+          "Output span size is too small for the selected mode");
+    }
+
+    auto &engine = conv1d_fftw::EngineR2C1D<T>::get(nfft);
+    auto &buf = engine.buf;
+    const size_t n_cx = nfft / 2 + 1;
+    const size_t L = block_size();
+
+    // Output o is sample o + offset of the causal convolution with the
+    // reversed kernel, which needs inputs [o + offset - (k - 1), o + offset]
+    const size_t offset = k - 1 - conv1d_pad<Mode>(k);
+
+    for (size_t o = 0; o < n_out; o += L) {
+      const size_t len = std::min(L, n_out - o);
+
+      // Window start in input coordinates, may be negative (zero padding)
+      const auto start = static_cast<std::ptrdiff_t>(o + offset) -
+                         static_cast<std::ptrdiff_t>(k - 1);
+      const auto lo = static_cast<size_t>(std::max<std::ptrdiff_t>(0, -start));
+      const auto hi = static_cast<size_t>(std::clamp<std::ptrdiff_t>(
+          static_cast<std::ptrdiff_t>(n) - start, 0,
+          static_cast<std::ptrdiff_t>(len + k - 1)));
+
+      std::fill(buf.in, buf.in + nfft, T{});
+      if (lo < hi) {
+        std::copy(input.begin() + (start + static_cast<std::ptrdiff_t>(lo)),
+                  input.begin() + (start + static_cast<std::ptrdiff_t>(hi)),
+                  buf.in + lo);
+      }
+      engine.forward();
+      if (n_kernels > 1) {
+        std::copy_n(&buf.out[0][0], 2 * n_cx, &input_spectrum[0][0]);
+      }
+
+      for (size_t f = 0; f < n_kernels; ++f) {
+        if (n_kernels > 1) {
+          multiply_spectrum<T>(buf.out, input_spectrum, spectra + f * n_cx,
+                               n_cx);
+        } else {
+          multiply_spectrum<T>(buf.out, spectra, n_cx);
+        }
+        engine.backward();
+
+        // The first k - 1 samples are corrupted by circular wrap-around
+        std::copy(buf.in + (k - 1), buf.in + (k - 1 + len),
+                  output.data() + f * n_out + o);
+      }
+    }
+  }
+};
+
+/**
+FFT convolution with a fixed kernel (conv1d_naive semantics, any ConvMode;
+unlike OverlapSave, which computes the true convolution for streaming).
+
+The kernel spectrum is computed once at construction, at the FFT size
+optimal_fft_size picks for inputs of `n` samples; every call then costs only
+the input-side FFTs. Plans and buffers come from the per-thread
+conv1d_fftw::EngineR2C1D cache, so convolvers of the same size share them.
+Inputs of other lengths still work, just at a possibly suboptimal size.
+*/
+template <conv1d_fftw::Floating T> struct FFTConvolver {
+  FFTFilterBank<T> bank;
+
+  FFTConvolver(std::span<const T> kernel, size_t n)
+      : bank(kernel, 1, optimal_fft_size(n, kernel.size())) {}
+
+  [[nodiscard]] auto fft_size() const -> size_t { return bank.nfft; }
+  [[nodiscard]] auto block_size() const -> size_t { return bank.block_size(); }
+
+  template <ConvMode Mode = ConvMode::Full>
+  void conv(std::span<const T> input, std::span<T> output) {
+    bank.template conv<Mode>(input, output);
+  }
+};
+
+// NOLINTEND(*-pointer-arithmetic, *-magic-numbers)
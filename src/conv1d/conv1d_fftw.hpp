@@ -0,0 +1,228 @@
+/**
+FFTW3 plans and buffers owned by the conv1d FFT paths.
+
+Kept independent of the <fftw.hpp> wrapper fftconv ships, whose engine API
+changes between fftconv versions. Plans share the process-wide FFTW wisdom,
+so fftw::WisdomSetup still applies to them.
+ */
+#pragma once
+
+#include "fftw_planner.hpp"
+#include "lru_cache.hpp"
+#include <cstddef>
+#include <fftw3.h>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+// NOLINTBEGIN(*-pointer-arithmetic)
+
+namespace conv1d_fftw {
+
+template <typename T>
+concept Floating = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template <Floating T> struct Traits {};
+
+template <> struct Traits<double> {
+  using Complex = fftw_complex;
+  using Plan = fftw_plan;
+
+  static auto alloc_real(size_t n) { return fftw_alloc_real(n); }
+  static auto alloc_complex(size_t n) { return fftw_alloc_complex(n); }
+  static void free(void *p) { fftw_free(p); }
+
+  static auto plan_r2c(int n, double *in, Complex *out, unsigned flags) {
+    return fftw_plan_dft_r2c_1d(n, in, out, flags);
+  }
+  static auto plan_c2r(int n, Complex *in, double *out, unsigned flags) {
+    return fftw_plan_dft_c2r_1d(n, in, out, flags);
+  }
+  static auto plan_dft(int n, Complex *in, Complex *out, int sign,
+                       unsigned flags) {
+    return fftw_plan_dft_1d(n, in, out, sign, flags);
+  }
+  static void execute(Plan plan) { fftw_execute(plan); }
+  static void destroy(Plan plan) { fftw_destroy_plan(plan); }
+};
+
+template <> struct Traits<float> {
+  using Complex = fftwf_complex;
+  using Plan = fftwf_plan;
+
+  static auto alloc_real(size_t n) { return fftwf_alloc_real(n); }
+  static auto alloc_complex(size_t n) { return fftwf_alloc_complex(n); }
+  static void free(void *p) { fftwf_free(p); }
+
+  static auto plan_r2c(int n, float *in, Complex *out, unsigned flags) {
+    return fftwf_plan_dft_r2c_1d(n, in, out, flags);
+  }
+  static auto plan_c2r(int n, Complex *in, float *out, unsigned flags) {
+    return fftwf_plan_dft_c2r_1d(n, in, out, flags);
+  }
+  static auto plan_dft(int n, Complex *in, Complex *out, int sign,
+                       unsigned flags) {
+    return fftwf_plan_dft_1d(n, in, out, sign, flags);
+  }
+  static void execute(Plan plan) { fftwf_execute(plan); }
+  static void destroy(Plan plan) { fftwf_destroy_plan(plan); }
+};
+
+template <Floating T> using Complex = typename Traits<T>::Complex;
+
+template <Floating T> auto alloc_real(size_t n) -> T * {
+  return Traits<T>::alloc_real(n);
+}
+template <Floating T> auto alloc_complex(size_t n) -> Complex<T> * {
+  return Traits<T>::alloc_complex(n);
+}
+template <Floating T> void free(void *p) { Traits<T>::free(p); }
+
+// Planner rigor of the conv1d plans. FFTW_MEASURE keeps the first call for
+// a new size well under a second; wisdom from a previous run skips it.
+inline constexpr unsigned planner_flags = FFTW_MEASURE;
+
+// The FFTW planner (plan creation and destruction) is not thread safe. The
+// lock is shared with hilbert's fftw.hpp (fftw_planner.hpp). fftconv's
+// wrapper plans without it, which is safe only because it is never run from
+// more than one thread (conv1d_parallel rejects the FFTConv backend).
+inline auto planner_mutex() -> std::mutex & { return fftw_planner::mutex(); }
+
+template <Floating T> struct Plan {
+  typename Traits<T>::Plan plan;
+
+  explicit Plan(typename Traits<T>::Plan plan) : plan(plan) {}
+  Plan(const Plan &) = delete;
+  Plan(Plan &&) = delete;
+  Plan &operator=(const Plan &) = delete;
+  Plan &operator=(Plan &&) = delete;
+  ~Plan() {
+    const std::lock_guard lock(planner_mutex());
+    Traits<T>::destroy(plan);
+  }
+
+  void execute() const { Traits<T>::execute(plan); }
+};
+
+/**
+Limits of the engine caches, applied per cache: each engine type has one
+cache per thread. Defaults to 64 entries and 512 MiB, as in hilbert's
+fftw.hpp. Lowered limits apply at the next miss.
+*/
+inline auto cache_limits() -> CacheLimits & {
+  static CacheLimits limits{.max_entries{64}, .max_bytes{size_t{512} << 20}};
+  return limits;
+}
+
+// Hits, misses, evictions and resident bytes of the engine caches, summed
+// over all threads and engine types
+inline auto cache_counters() -> CacheCounters & {
+  static CacheCounters counters;
+  return counters;
+}
+
+// One engine per size and thread, built on first use. The reference stays
+// valid until a later miss in the same cache evicts it.
+template <class Engine> auto get_cached(size_t n) -> Engine & {
+  thread_local LruCache<size_t, Engine> cache(cache_limits(), cache_counters());
+  return cache.get(n);
+}
+
+/**
+Real FFT of size n: forward() transforms in (n reals) to out (n / 2 + 1
+complex), backward() transforms out back to in, unnormalized. backward()
+overwrites out.
+*/
+template <Floating T> struct EngineR2C1D {
+  struct Buffer {
+    T *in;
+    Complex<T> *out;
+  };
+
+  size_t n;
+  Buffer buf;
+  std::unique_ptr<Plan<T>> plan_forward;
+  std::unique_ptr<Plan<T>> plan_backward;
+
+  explicit EngineR2C1D(size_t n)
+      : n(n), buf{alloc_real<T>(n), alloc_complex<T>(n / 2 + 1)} {
+    const std::lock_guard lock(planner_mutex());
+    const auto sz = static_cast<int>(n);
+    plan_forward = std::make_unique<Plan<T>>(
+        Traits<T>::plan_r2c(sz, buf.in, buf.out, planner_flags));
+    plan_backward = std::make_unique<Plan<T>>(
+        Traits<T>::plan_c2r(sz, buf.out, buf.in, planner_flags));
+  }
+  EngineR2C1D(const EngineR2C1D &) = delete;
+  EngineR2C1D(EngineR2C1D &&) = delete;
+  EngineR2C1D &operator=(const EngineR2C1D &) = delete;
+  EngineR2C1D &operator=(EngineR2C1D &&) = delete;
+  ~EngineR2C1D() {
+    plan_forward.reset();
+    plan_backward.reset();
+    free<T>(buf.in);
+    free<T>(buf.out);
+  }
+
+  static auto get(size_t n) -> EngineR2C1D & {
+    return get_cached<EngineR2C1D>(n);
+  }
+
+  [[nodiscard]] auto bytes() const -> size_t {
+    return n * sizeof(T) + (n / 2 + 1) * sizeof(Complex<T>);
+  }
+
+  void forward() const { plan_forward->execute(); }
+  void backward() const { plan_backward->execute(); }
+};
+
+/**
+Complex FFT of size n: forward() transforms in to out, backward() transforms
+out back to in, unnormalized.
+*/
+template <Floating T> struct EngineDFT1D {
+  struct Buffer {
+    Complex<T> *in;
+    Complex<T> *out;
+  };
+
+  size_t n;
+  Buffer buf;
+  std::unique_ptr<Plan<T>> plan_forward;
+  std::unique_ptr<Plan<T>> plan_backward;
+
+  explicit EngineDFT1D(size_t n)
+      : n(n), buf{alloc_complex<T>(n), alloc_complex<T>(n)} {
+    const std::lock_guard lock(planner_mutex());
+    const auto sz = static_cast<int>(n);
+    plan_forward = std::make_unique<Plan<T>>(Traits<T>::plan_dft(
+        sz, buf.in, buf.out, FFTW_FORWARD, planner_flags));
+    plan_backward = std::make_unique<Plan<T>>(Traits<T>::plan_dft(
+        sz, buf.out, buf.in, FFTW_BACKWARD, planner_flags));
+  }
+  EngineDFT1D(const EngineDFT1D &) = delete;
+  EngineDFT1D(EngineDFT1D &&) = delete;
+  EngineDFT1D &operator=(const EngineDFT1D &) = delete;
+  EngineDFT1D &operator=(EngineDFT1D &&) = delete;
+  ~EngineDFT1D() {
+    plan_forward.reset();
+    plan_backward.reset();
+    free<T>(buf.in);
+    free<T>(buf.out);
+  }
+
+  static auto get(size_t n) -> EngineDFT1D & {
+    return get_cached<EngineDFT1D>(n);
+  }
+
+  [[nodiscard]] auto bytes() const -> size_t {
+    return 2 * n * sizeof(Complex<T>);
+  }
+
+  void forward() const { plan_forward->execute(); }
+  void backward() const { plan_backward->execute(); }
+};
+
+} // namespace conv1d_fftw
+
+// NOLINTEND(*-pointer-arithmetic)
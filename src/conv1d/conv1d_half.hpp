@@ -0,0 +1,197 @@
+/**
+conv1d with 16-bit floating point storage (_Float16 or bf16::BFloat16) and fp32
+accumulation, for bandwidth bound streaming
+ */
+#pragma once
+
+#include "bfloat16.hpp"
+#include "conv1d.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// NOLINTBEGIN(*-pointer-arithmetic, *-magic-numbers)
+
+template <typename S>
+concept HalfStorage = std::is_same_v<S, bf16::BFloat16>
+#if defined(__FLT16_MAX__)
+                      || std::is_same_v<S, _Float16>
+#endif
+    ;
+
+namespace simd {
+
+/*
+Load W storage values as one fp32 vector of Ops, and store one back.
+The generic version converts lane by lane through a stack buffer; the
+specializations below use the hardware conversions. These round to nearest
+even like the scalar conversions, except that the AVX-512-BF16
+instructions flush fp32 denormals to zero.
+*/
+template <class Ops, typename S> struct HalfConvert {
+  using V = typename Ops::V;
+  static auto load(const S *p) -> V {
+    alignas(64) std::array<float, Ops::W> tmp;
+    for (size_t i = 0; i < Ops::W; ++i) { tmp[i] = static_cast<float>(p[i]); }
+    return Ops::loadu(tmp.data());
+  }
+  static void store(S *p, V v) {
+    alignas(64) std::array<float, Ops::W> tmp;
+    Ops::storeu(tmp.data(), v);
+    for (size_t i = 0; i < Ops::W; ++i) { p[i] = static_cast<S>(tmp[i]); }
+  }
+};
+
+#if defined(__AVX2__)
+
+#if defined(__F16C__) && defined(__FLT16_MAX__)
+template <> struct HalfConvert<AVX2<float>, _Float16> {
+  static auto load(const _Float16 *p) -> __m256 {
+    return _mm256_cvtph_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+  }
+  static void store(_Float16 *p, __m256 v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p),
+                     _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT |
+                                            _MM_FROUND_NO_EXC));
+  }
+};
+#endif
+
+template <> struct HalfConvert<AVX2<float>, bf16::BFloat16> {
+  static auto load(const bf16::BFloat16 *p) -> __m256 {
+    return bf16::load8(p);
+  }
+  static void store(bf16::BFloat16 *p, __m256 v) { bf16::store8(p, v); }
+};
+
+#endif
+
+#if defined(__AVX512F__)
+
+#if defined(__FLT16_MAX__)
+template <> struct HalfConvert<AVX512<float>, _Float16> {
+#if defined(__AVX512FP16__)
+  static auto load(const _Float16 *p) -> __m512 {
+    return _mm512_cvtxph_ps(_mm256_loadu_ph(p));
+  }
+  static void store(_Float16 *p, __m512 v) {
+    _mm256_storeu_ph(p, _mm512_cvtxps_ph(v));
+  }
+#else
+  static auto load(const _Float16 *p) -> __m512 {
+    return _mm512_cvtph_ps(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+  }
+  static void store(_Float16 *p, __m512 v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p),
+                        _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT |
+                                               _MM_FROUND_NO_EXC));
+  }
+#endif
+};
+#endif
+
+template <> struct HalfConvert<AVX512<float>, bf16::BFloat16> {
+  static auto load(const bf16::BFloat16 *p) -> __m512 {
+    return bf16::load16(p);
+  }
+  static void store(bf16::BFloat16 *p, __m512 v) { bf16::store16(p, v); }
+};
+
+#endif
+
+// dst[i] = float(src[i]) for i in [0, n)
+template <typename S> void widen(const S *src, size_t n, float *dst) {
+  using Ops = Native<float>;
+  size_t i = 0;
+  for (; i + Ops::W <= n; i += Ops::W) {
+    Ops::storeu(dst + i, HalfConvert<Ops, S>::load(src + i));
+  }
+  for (; i < n; ++i) { dst[i] = static_cast<float>(src[i]); }
+}
+
+// dst[i] = S(src[i]) for i in [0, n)
+template <typename S> void narrow(const float *src, size_t n, S *dst) {
+  using Ops = Native<float>;
+  size_t i = 0;
+  for (; i + Ops::W <= n; i += Ops::W) {
+    HalfConvert<Ops, S>::store(dst + i, Ops::loadu(src + i));
+  }
+  for (; i < n; ++i) { dst[i] = static_cast<S>(src[i]); }
+}
+
+} // namespace simd
+
+// Outputs per tile of conv1d_simd_storage: the fp32 staging buffers for
+// input and output stay in L1
+constexpr size_t STORAGE_TILE = 2048;
+
+/**
+Direct SIMD convolution (conv1d_naive semantics) with input and output
+stored as S (_Float16 or bf16::BFloat16), fp32 taps and fp32 accumulation.
+
+Halves the memory traffic of the fp32 path. The blocked kernel reloads
+every input vector once per tap, so instead of converting in its inner loop
+the input is widened to fp32 one L1-sized tile at a time (zero padded at the
+edges for Full/Same), run through the fp32 kernel, and the outputs narrowed
+once on store. Conversions use F16C / AVX-512 / AVX-512-FP16 / AVX-512-BF16
+where available.
+*/
+template <HalfStorage S, ConvMode Mode = ConvMode::Full>
+void conv1d_simd_storage(const std::span<const S> input,
+                         const std::span<const float> kernel,
+                         std::span<S> output) {
+  const size_t n = input.size();
+  const size_t k = kernel.size();
+  if (k == 0) { throw std::invalid_argument("Kernel must not be empty"); }
+  if constexpr (Mode == ConvMode::Valid) {
+    if (n < k) {
+      throw std::invalid_argument("Input is shorter than the kernel");
+    }
+  }
+  const size_t n_out = conv1d_output_size<Mode>(n, k);
+  if (output.size() < n_out) {
+    throw std::invalid_argument(
+        "Output span size is too small for the selected mode");
+  }
+
+  thread_local std::vector<float> in_tile;
+  thread_local std::vector<float> out_tile;
+  in_tile.resize(STORAGE_TILE + k - 1);
+  out_tile.resize(STORAGE_TILE);
+
+  const auto pad = static_cast<std::ptrdiff_t>(conv1d_pad<Mode>(k));
+  for (size_t t = 0; t < n_out; t += STORAGE_TILE) {
+    const size_t len = std::min(STORAGE_TILE, n_out - t);
+    const size_t win = len + k - 1;
+
+    // in_tile[r] = input[t - pad + r], zero outside [lo, hi)
+    const std::ptrdiff_t first = static_cast<std::ptrdiff_t>(t) - pad;
+    const auto lo = static_cast<size_t>(std::clamp<std::ptrdiff_t>(
+        -first, 0, static_cast<std::ptrdiff_t>(win)));
+    const auto hi = static_cast<size_t>(std::clamp<std::ptrdiff_t>(
+        static_cast<std::ptrdiff_t>(n) - first,
+        static_cast<std::ptrdiff_t>(lo), static_cast<std::ptrdiff_t>(win)));
+    std::fill(in_tile.begin(), in_tile.begin() + lo, 0.F);
+    if (hi > lo) {
+      simd::widen(input.data() + (first + static_cast<std::ptrdiff_t>(lo)),
+                  hi - lo, in_tile.data() + lo);
+    }
+    std::fill(in_tile.begin() + hi, in_tile.begin() + win, 0.F);
+
+    simd::conv1d_valid_blocked<simd::Native<float>, simd::BLOCKS>(
+        in_tile.data(), len, kernel.data(), k, out_tile.data());
+    simd::narrow(out_tile.data(), len, output.data() + t);
+  }
+}
+
+// NOLINTEND(*-pointer-arithmetic, *-magic-numbers)
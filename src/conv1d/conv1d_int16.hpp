@@ -0,0 +1,277 @@
+/**
+Integer conv1d for raw int16 ADC data: int16 x int16 -> int32 accumulation
+ */
+#pragma once
+
+#include "conv1d.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+// NOLINTBEGIN(*-pointer-arithmetic, *-magic-numbers)
+
+namespace simd {
+
+// "valid" mode reference: out[i] = sum_j in[i + j] * kernel[j]
+inline void conv1d_int16_scalar(const int16_t *in, size_t n_out,
+                                const int16_t *kernel, size_t k,
+                                int32_t *out) {
+  for (size_t i = 0; i < n_out; ++i) {
+    int32_t acc = 0;
+    for (size_t j = 0; j < k; ++j) {
+      acc += static_cast<int32_t>(in[i + j]) * kernel[j];
+    }
+    out[i] = acc;
+  }
+}
+
+#if defined(__AVX2__)
+
+// acc + (a[2i] * b[2i] + a[2i + 1] * b[2i + 1]) per int32 lane
+inline auto dot_i16(__m256i acc, __m256i a, __m256i b) -> __m256i {
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+  return _mm256_dpwssd_epi32(acc, a, b);
+#elif defined(__AVXVNNI__)
+  return _mm256_dpwssd_avx_epi32(acc, a, b);
+#else
+  return _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+#endif
+}
+
+/*
+16 outputs per block. Taps are consumed in pairs: `pairs[p]` packs
+(kernel[2p], kernel[2p + 1]) into one int32, and the inputs x[i + 2p] and
+x[i + 2p + 1] are interleaved with unpacklo/hi so one madd gives both
+products for 8 outputs. unpack works per 128-bit lane, so the two
+accumulators hold outputs {0-3, 8-11} and {4-7, 12-15} until the store.
+*/
+template <size_t... B>
+inline void conv1d_int16_block(const int16_t *in, const int32_t *pairs,
+                               size_t n_pairs, int32_t *out,
+                               std::index_sequence<B...> /*blocks*/) {
+  // NOLINTBEGIN(*-avoid-c-arrays): std::array drops __m256i's attributes
+  __m256i lo[sizeof...(B)]{(static_cast<void>(B), _mm256_setzero_si256())...};
+  __m256i hi[sizeof...(B)]{(static_cast<void>(B), _mm256_setzero_si256())...};
+  // NOLINTEND(*-avoid-c-arrays)
+
+  for (size_t p = 0; p < n_pairs; ++p) {
+    const __m256i kv = _mm256_set1_epi32(pairs[p]);
+    const int16_t *x = in + 2 * p;
+    const auto step = [&](size_t b) {
+      const auto *x0 = reinterpret_cast<const __m256i *>(x + 16 * b);
+      const auto *x1 = reinterpret_cast<const __m256i *>(x + 16 * b + 1);
+      const __m256i a = _mm256_loadu_si256(x0);
+      const __m256i c = _mm256_loadu_si256(x1);
+      lo[b] = dot_i16(lo[b], _mm256_unpacklo_epi16(a, c), kv);
+      hi[b] = dot_i16(hi[b], _mm256_unpackhi_epi16(a, c), kv);
+    };
+    (step(B), ...);
+  }
+
+  const auto store = [&](size_t b) {
+    auto *dst = reinterpret_cast<__m256i *>(out + 16 * b);
+    _mm256_storeu_si256(dst, _mm256_permute2x128_si256(lo[b], hi[b], 0x20));
+    _mm256_storeu_si256(dst + 1,
+                        _mm256_permute2x128_si256(lo[b], hi[b], 0x31));
+  };
+  (store(B), ...);
+}
+
+// `k` must be even; `in` must hold n_out + k - 1 samples
+inline void conv1d_int16_avx2(const int16_t *in, size_t n_out,
+                              const int16_t *kernel, size_t k,
+                              int32_t *out) {
+  thread_local std::vector<int32_t> pairs;
+  pairs.resize(k / 2);
+  for (size_t p = 0; p < k / 2; ++p) {
+    const auto k0 = static_cast<uint16_t>(kernel[2 * p]);
+    const auto k1 = static_cast<uint16_t>(kernel[2 * p + 1]);
+    pairs[p] = static_cast<int32_t>(k0 | (static_cast<uint32_t>(k1) << 16));
+  }
+
+  constexpr size_t Blocks = 4;
+  size_t i = 0;
+  for (; i + 16 * Blocks <= n_out; i += 16 * Blocks) {
+    conv1d_int16_block(in + i, pairs.data(), k / 2, out + i,
+                       std::make_index_sequence<Blocks>{});
+  }
+  for (; i + 16 <= n_out; i += 16) {
+    conv1d_int16_block(in + i, pairs.data(), k / 2, out + i,
+                       std::make_index_sequence<1>{});
+  }
+  conv1d_int16_scalar(in + i, n_out - i, kernel, k, out + i);
+}
+
+#endif
+
+#if defined(__ARM_NEON__)
+
+// 8 outputs per block, one widening multiply-accumulate per tap and half
+template <size_t... B>
+inline void conv1d_int16_block(const int16_t *in, const int16_t *kernel,
+                               size_t k, int32_t *out,
+                               std::index_sequence<B...> /*blocks*/) {
+  // NOLINTBEGIN(*-avoid-c-arrays), see the AVX2 block
+  int32x4_t lo[sizeof...(B)]{(static_cast<void>(B), vdupq_n_s32(0))...};
+  int32x4_t hi[sizeof...(B)]{(static_cast<void>(B), vdupq_n_s32(0))...};
+  // NOLINTEND(*-avoid-c-arrays)
+
+  for (size_t j = 0; j < k; ++j) {
+    const int16_t kv = kernel[j];
+    const auto step = [&](size_t b) {
+      const int16x8_t x = vld1q_s16(in + j + 8 * b);
+      lo[b] = vmlal_n_s16(lo[b], vget_low_s16(x), kv);
+      hi[b] = vmlal_n_s16(hi[b], vget_high_s16(x), kv);
+    };
+    (step(B), ...);
+  }
+
+  const auto store = [&](size_t b) {
+    vst1q_s32(out + 8 * b, lo[b]);
+    vst1q_s32(out + 8 * b + 4, hi[b]);
+  };
+  (store(B), ...);
+}
+
+inline void conv1d_int16_neon(const int16_t *in, size_t n_out,
+                              const int16_t *kernel, size_t k,
+                              int32_t *out) {
+  constexpr size_t Blocks = 4;
+  size_t i = 0;
+  for (; i + 8 * Blocks <= n_out; i += 8 * Blocks) {
+    conv1d_int16_block(in + i, kernel, k, out + i,
+                       std::make_index_sequence<Blocks>{});
+  }
+  for (; i + 8 <= n_out; i += 8) {
+    conv1d_int16_block(in + i, kernel, k, out + i,
+                       std::make_index_sequence<1>{});
+  }
+  conv1d_int16_scalar(in + i, n_out - i, kernel, k, out + i);
+}
+
+#endif
+
+} // namespace simd
+
+/**
+int16 direct convolution with int32 outputs, conv1d_naive semantics.
+
+Uses _mm256_madd_epi16 on AVX2 (the fused _mm256_dpwssd_epi32 when VNNI
+is available) and vmlal_s16 on NEON. The int32 accumulators wrap if
+sum_j |kernel[j]| * 32768 >= 2^31; kernels from quantize_kernel() never do.
+
+The AVX2 kernel takes taps in pairs, so an odd length kernel gets a zero
+tap appended and the input is staged with one extra zero sample.
+*/
+template <ConvMode Mode = ConvMode::Full>
+void conv1d_int16(const std::span<const int16_t> input,
+                  const std::span<const int16_t> kernel,
+                  std::span<int32_t> output) {
+  const size_t n = input.size();
+  const size_t k = kernel.size();
+  if (k == 0) { throw std::invalid_argument("Kernel must not be empty"); }
+  if constexpr (Mode == ConvMode::Valid) {
+    if (n < k) {
+      throw std::invalid_argument("Input is shorter than the kernel");
+    }
+  }
+  const size_t n_out = conv1d_output_size<Mode>(n, k);
+  if (output.size() < n_out) {
+    throw std::invalid_argument(
+        "Output span size is too small for the selected mode");
+  }
+
+#if defined(__AVX2__)
+  const size_t k_even = k + k % 2;
+  thread_local std::vector<int16_t> kernel_even;
+  kernel_even.assign(kernel.begin(), kernel.end());
+  kernel_even.resize(k_even, 0);
+#else
+  const size_t k_even = k;
+#endif
+
+  const int16_t *in = input.data();
+  if (Mode != ConvMode::Valid || k_even != k) {
+    thread_local std::vector<int16_t> padded;
+    padded.assign(n_out + k_even - 1, 0);
+    std::copy(input.begin(), input.end(),
+              padded.begin() + conv1d_pad<Mode>(k));
+    in = padded.data();
+  }
+
+#if defined(__AVX2__)
+  simd::conv1d_int16_avx2(in, n_out, kernel_even.data(), k_even,
+                          output.data());
+#elif defined(__ARM_NEON__)
+  simd::conv1d_int16_neon(in, n_out, kernel.data(), k, output.data());
+#else
+  simd::conv1d_int16_scalar(in, n_out, kernel.data(), k, output.data());
+#endif
+}
+
+/**
+Fixed point kernel: kernel[j] ~= taps[j] * 2^-shift.
+
+`shift` is the largest one for which the taps fit int16 and
+sum_j |taps[j]| * 32768 < 2^31, so conv1d_int16 cannot overflow on any
+int16 input. Multiply the int32 output by scale() to get back to the units
+of the floating point kernel.
+*/
+struct QuantizedKernel {
+  std::vector<int16_t> taps;
+  int shift{};
+
+  template <typename T> [[nodiscard]] auto scale() const -> T {
+    return std::ldexp(T{1}, -shift);
+  }
+};
+
+template <typename T>
+  requires(std::is_floating_point_v<T>)
+auto quantize_kernel(std::span<const T> kernel) -> QuantizedKernel {
+  constexpr double tap_max = 32767;
+  constexpr double l1_max = 65535; // 65535 * 32768 < 2^31
+
+  double peak = 0;
+  double l1 = 0;
+  for (const auto h : kernel) {
+    peak = std::max(peak, std::abs(static_cast<double>(h)));
+    l1 += std::abs(static_cast<double>(h));
+  }
+
+  QuantizedKernel q;
+  q.taps.resize(kernel.size());
+  if (peak == 0) { return q; }
+
+  // Rounding can push the taps over the bounds, so step down until they fit
+  q.shift = static_cast<int>(
+      std::floor(std::log2(std::min(tap_max / peak, l1_max / l1))));
+  for (;; --q.shift) {
+    double sum = 0;
+    bool fits = true;
+    for (size_t j = 0; j < kernel.size(); ++j) {
+      const double v =
+          std::round(std::ldexp(static_cast<double>(kernel[j]), q.shift));
+      fits = fits && std::abs(v) <= tap_max;
+      sum += std::abs(v);
+      q.taps[j] = static_cast<int16_t>(std::clamp(v, -tap_max, tap_max));
+    }
+    if (fits && sum <= l1_max) { break; }
+  }
+  return q;
+}
+
+// NOLINTEND(*-pointer-arithmetic, *-magic-numbers)
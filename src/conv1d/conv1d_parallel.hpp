@@ -0,0 +1,100 @@
+/**
+Multithreaded conv1d for long signals: the output is split into tiles that
+are convolved independently by an inner backend on the OpenCV thread pool.
+ */
+#pragma once
+
+#include "conv1d.hpp"
+#include "conv1d_auto.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <opencv2/opencv.hpp>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// NOLINTBEGIN(*-pointer-arithmetic, *-magic-numbers)
+
+// Input + output bytes of one tile, sized to stay resident in L2
+inline constexpr size_t PARALLEL_TILE_BYTES = 128 * 1024;
+
+/*
+Default number of output samples per tile. At least 4 * k so the
+(k - 1) sample halo each tile re-reads stays under ~25% extra input.
+*/
+template <typename T>
+constexpr auto conv1d_parallel_tile(size_t k) -> size_t {
+  return std::max(PARALLEL_TILE_BYTES / (2 * sizeof(T)), 4 * k);
+}
+
+/**
+conv1d with conv1d_naive semantics, split over cv::parallel_for_.
+
+Output tile [o0, o0 + m) only reads input [o0 - pad, o0 - pad + m + k - 1),
+so each tile runs `backend` in "valid" mode on that window (its own samples
+plus a k - 1 sample halo). Interior tiles read the input in place; tiles that
+overhang the signal edges are zero padded into a thread_local buffer.
+
+The number of threads is the OpenCV pool size (cv::setNumThreads).
+`tile == 0` picks conv1d_parallel_tile<T>(k).
+*/
+template <typename T, ConvMode Mode = ConvMode::Full>
+void conv1d_parallel(const std::span<const T> input,
+                     const std::span<const T> kernel, std::span<T> output,
+                     Conv1dBackend backend = Conv1dBackend::SIMD,
+                     size_t tile = 0) {
+  const size_t n = input.size();
+  const size_t k = kernel.size();
+  if (k == 0) { throw std::invalid_argument("Kernel must not be empty"); }
+  if constexpr (Mode == ConvMode::Valid) {
+    if (n < k) {
+      throw std::invalid_argument("Input is shorter than the kernel");
+    }
+  }
+  const size_t n_out = conv1d_output_size<Mode>(n, k);
+  if (output.size() < n_out) {
+    throw std::invalid_argument(
+        "Output span size is too small for the selected mode");
+  }
+  // fftconv caches one set of FFTW buffers per size for the whole process
+  if (backend == Conv1dBackend::FFTConv) {
+    throw std::invalid_argument(
+        "FFTConv backend is not safe to run from multiple threads");
+  }
+
+  if (tile == 0) { tile = conv1d_parallel_tile<T>(k); }
+  const size_t pad = conv1d_pad<Mode>(k);
+  const size_t n_tiles = (n_out + tile - 1) / tile;
+
+  const auto run = [&](const cv::Range &r) {
+    thread_local std::vector<T> window;
+
+    for (int t = r.start; t < r.end; ++t) {
+      const size_t o0 = static_cast<size_t>(t) * tile;
+      const size_t m = std::min(tile, n_out - o0);
+      const size_t len = m + k - 1;
+
+      std::span<const T> src;
+      if (o0 >= pad && o0 - pad + len <= n) {
+        src = input.subspan(o0 - pad, len);
+      } else {
+        // Input index of window[0] is o0 - pad (may be negative)
+        window.assign(len, T{});
+        const size_t skip = o0 < pad ? pad - o0 : 0;
+        const size_t first = o0 + skip - pad;
+        if (first < n) {
+          const size_t count = std::min(len - skip, n - first);
+          std::copy_n(input.begin() + first, count, window.begin() + skip);
+        }
+        src = window;
+      }
+
+      detail::conv1d_run_backend<T, ConvMode::Valid>(backend, src, kernel,
+                                                     output.subspan(o0, m));
+    }
+  };
+
+  cv::parallel_for_(cv::Range(0, static_cast<int>(n_tiles)), run);
+}
+
+// NOLINTEND(*-pointer-arithmetic, *-magic-numbers)
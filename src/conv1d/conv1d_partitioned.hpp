@@ -0,0 +1,129 @@
+/**
+Uniformly partitioned overlap-save convolution for long kernels at low latency
+ */
+#pragma once
+
+#include "conv1d_fft.hpp"
+#include "conv1d_fftw.hpp"
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// NOLINTBEGIN(*-pointer-arithmetic, *-magic-numbers)
+
+/**
+Streaming FIR filter with a latency of one block, for kernels much longer
+than the block (uniformly partitioned overlap-save, UPOLS).
+
+The kernel is split into P = ceil(k / block) partitions of `block` taps, each
+transformed once at FFT size 2 * block. Every `process` block costs one
+forward and one inverse FFT of size 2 * block, plus P spectrum
+multiply-adds against a frequency-domain delay line (FDL) holding the
+spectra of the last P input blocks.
+
+Output follows StreamingConv1d: y[i] = sum_j kernel[j] * x[i - j], with the
+input history carried across calls.
+*/
+template <conv1d_fftw::Floating T> struct PartitionedConvolver {
+  using Cx = conv1d_fftw::Complex<T>;
+
+  size_t block;
+  size_t nfft;
+  size_t n_cx;
+  size_t partitions;
+  size_t head{}; // FDL slot of the newest input spectrum
+
+  Cx *spectra; // partitions * n_cx kernel partition spectra
+  Cx *fdl;     // partitions * n_cx input spectra, ring buffer
+  std::vector<T> prev; // previous input block
+
+  PartitionedConvolver(std::span<const T> kernel, size_t block)
+      : block(block), nfft(2 * block), n_cx(block + 1),
+        partitions((kernel.size() + block - 1) / std::max<size_t>(block, 1)),
+        spectra(nullptr), fdl(nullptr), prev(block, T{}) {
+    if (kernel.empty() || block == 0) {
+      throw std::invalid_argument("Kernel and block size must be non-zero");
+    }
+    spectra = conv1d_fftw::alloc_complex<T>(partitions * n_cx);
+    fdl = conv1d_fftw::alloc_complex<T>(partitions * n_cx);
+    std::fill(&fdl[0][0], &fdl[0][0] + 2 * partitions * n_cx, T{});
+
+    auto &engine = conv1d_fftw::EngineR2C1D<T>::get(nfft);
+    auto &buf = engine.buf;
+    const T fct = static_cast<T>(1. / nfft);
+    for (size_t p = 0; p < partitions; ++p) {
+      const size_t first = p * block;
+      const size_t len = std::min(block, kernel.size() - first);
+      std::copy(kernel.begin() + first, kernel.begin() + first + len, buf.in);
+      std::fill(buf.in + len, buf.in + nfft, T{});
+      engine.forward();
+
+      Cx *dst = spectra + p * n_cx;
+      for (size_t i = 0; i < n_cx; ++i) {
+        dst[i][0] = buf.out[i][0] * fct;
+        dst[i][1] = buf.out[i][1] * fct;
+      }
+    }
+  }
+  PartitionedConvolver(const PartitionedConvolver &) = delete;
+  PartitionedConvolver(PartitionedConvolver &&) = delete;
+  PartitionedConvolver &operator=(const PartitionedConvolver &) = delete;
+  PartitionedConvolver &operator=(PartitionedConvolver &&) = delete;
+  ~PartitionedConvolver() noexcept {
+    if (spectra) conv1d_fftw::free<T>(spectra);
+    if (fdl) conv1d_fftw::free<T>(fdl);
+  }
+
+  // Forget the carried history (start of a new signal)
+  void reset() {
+    std::fill(&fdl[0][0], &fdl[0][0] + 2 * partitions * n_cx, T{});
+    std::fill(prev.begin(), prev.end(), T{});
+    head = 0;
+  }
+
+  /*
+  input.size() must be a multiple of the block size,
+  output.size() must be >= input.size()
+  */
+  void process(std::span<const T> input, std::span<T> output) {
+    if (input.size() % block != 0) {
+      throw std::invalid_argument(
+          "Input size must be a multiple of the block size");
+    }
+    if (output.size() < input.size()) {
+      throw std::invalid_argument(
+          "Output span size is too small for the input chunk");
+    }
+
+    auto &engine = conv1d_fftw::EngineR2C1D<T>::get(nfft);
+    auto &buf = engine.buf;
+
+    for (size_t b = 0; b < input.size(); b += block) {
+      const auto chunk = input.subspan(b, block);
+
+      // Sliding window [previous block, current block]
+      std::copy(prev.begin(), prev.end(), buf.in);
+      std::copy(chunk.begin(), chunk.end(), buf.in + block);
+      std::copy(chunk.begin(), chunk.end(), prev.begin());
+
+      head = (head + 1) % partitions;
+      engine.forward();
+      std::copy_n(&buf.out[0][0], 2 * n_cx, &fdl[head * n_cx][0]);
+
+      // Y = sum_p X[t - p] * H[p], accumulated in place of the FFT output
+      multiply_spectrum<T>(buf.out, spectra, n_cx);
+      for (size_t p = 1; p < partitions; ++p) {
+        const size_t slot = (head + partitions - p) % partitions;
+        multiply_accumulate_spectrum<T>(buf.out, fdl + slot * n_cx,
+                                        spectra + p * n_cx, n_cx);
+      }
+      engine.backward();
+
+      // The first half is corrupted by circular wrap-around
+      std::copy(buf.in + block, buf.in + nfft, output.data() + b);
+    }
+  }
+};
+
+// NOLINTEND(*-pointer-arithmetic, *-magic-numbers)
@@ -0,0 +1,196 @@
+/**
+Polyphase FIR decimators and interpolators on top of the conv1d SIMD kernels
+ */
+#pragma once
+
+#include "conv1d.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// NOLINTBEGIN(*-pointer-arithmetic)
+
+namespace detail {
+
+/*
+Split a kernel into `factor` polyphase branches, branch p holding the taps
+kernel[q * factor + p] in reverse order (ready for the "valid" correlation
+kernels). Branches are empty when the kernel is shorter than `factor`.
+*/
+template <typename T>
+auto polyphase_branches(std::span<const T> kernel, size_t factor)
+    -> std::vector<std::vector<T>> {
+  std::vector<std::vector<T>> branches(factor);
+  for (size_t p = 0; p < factor; ++p) {
+    for (size_t j = p; j < kernel.size(); j += factor) {
+      branches[p].push_back(kernel[j]);
+    }
+    std::reverse(branches[p].begin(), branches[p].end());
+  }
+  return branches;
+}
+
+} // namespace detail
+
+/**
+Stateful filter-then-downsample by `factor` (M).
+
+Output m is sample m * M of the causal filter y[t] = sum_j kernel[j] x[t - j]
+(same as StreamingConv1d), but only the kept outputs are computed: branch p
+of the kernel runs at the low rate on every M-th input sample, so each
+output costs k multiplies instead of M * k.
+
+Chunks may have any length; the last k - 1 input samples and the position
+of the next kept output are carried across `process` calls.
+*/
+template <typename T>
+  requires(std::is_floating_point_v<T>)
+struct PolyphaseDecimator {
+  size_t factor;
+  size_t k;
+  std::vector<std::vector<T>> branches;
+  std::vector<T> buf;    // k - 1 samples of history + current chunk
+  std::vector<T> stream; // one deinterleaved branch input
+  size_t offset{};       // index in the next chunk of the next kept output
+
+  PolyphaseDecimator(std::span<const T> kernel, size_t factor)
+      : factor(factor), k(kernel.size()) {
+    if (kernel.empty() || factor == 0) {
+      throw std::invalid_argument("Kernel and factor must be non-zero");
+    }
+    branches = detail::polyphase_branches<T>(kernel, factor);
+    buf.assign(k - 1, T{});
+  }
+
+  // Number of outputs the next process() call produces for n input samples
+  [[nodiscard]] auto output_size(size_t n) const -> size_t {
+    return offset < n ? (n - offset + factor - 1) / factor : 0;
+  }
+
+  // Forget the carried history (start of a new signal)
+  void reset() {
+    buf.assign(k - 1, T{});
+    offset = 0;
+  }
+
+  // Returns the number of outputs written (output_size(input.size()))
+  auto process(std::span<const T> input, std::span<T> output) -> size_t {
+    const size_t n = input.size();
+    const size_t n_out = output_size(n);
+    if (output.size() < n_out) {
+      throw std::invalid_argument(
+          "Output span size is too small for the input chunk");
+    }
+
+    const size_t hist = k - 1;
+    buf.resize(hist + n);
+    std::copy(input.begin(), input.end(), buf.begin() + hist);
+
+    if (n_out > 0) {
+      using Ops = simd::Native<T>;
+      for (size_t p = 0; p < factor; ++p) {
+        const auto &taps = branches[p];
+        const size_t q = taps.size();
+        if (q == 0) { continue; }
+
+        // stream[r] = x[t0 - p + (r - (q - 1)) * M], t0 the first kept output
+        const size_t len = n_out + q - 1;
+        const size_t first = hist + offset - p - (q - 1) * factor;
+        stream.resize(len);
+        for (size_t r = 0; r < len; ++r) {
+          stream[r] = buf[first + r * factor];
+        }
+
+        // Branch 0 always has taps and initializes the output
+        if (p == 0) {
+          simd::conv1d_valid_blocked<Ops, simd::BLOCKS>(
+              stream.data(), n_out, taps.data(), q, output.data());
+        } else {
+          simd::conv1d_valid_blocked<Ops, simd::BLOCKS, true>(
+              stream.data(), n_out, taps.data(), q, output.data());
+        }
+      }
+    }
+
+    offset = offset + n_out * factor - n;
+    std::copy(buf.end() - static_cast<std::ptrdiff_t>(hist), buf.end(),
+              buf.begin());
+    buf.resize(hist);
+    return n_out;
+  }
+};
+
+/**
+Stateful upsample-by-`factor` (L) then filter.
+
+Equivalent to zero stuffing L - 1 samples after every input sample and
+running the causal filter y[t] = sum_j kernel[j] u[t - j], without the
+multiplies by zero: output m * L + p is branch p of the kernel applied to
+the input at the low rate. The DC gain of the kernel should be L to
+preserve amplitude.
+
+Every input sample produces exactly L outputs.
+*/
+template <typename T>
+  requires(std::is_floating_point_v<T>)
+struct PolyphaseInterpolator {
+  size_t factor;
+  size_t hist; // history samples carried between calls
+  std::vector<std::vector<T>> branches;
+  std::vector<T> buf;    // history + current chunk
+  std::vector<T> branch; // one branch output at the low rate
+
+  PolyphaseInterpolator(std::span<const T> kernel, size_t factor)
+      : factor(factor) {
+    if (kernel.empty() || factor == 0) {
+      throw std::invalid_argument("Kernel and factor must be non-zero");
+    }
+    branches = detail::polyphase_branches<T>(kernel, factor);
+    hist = branches[0].size() - 1;
+    buf.assign(hist, T{});
+  }
+
+  [[nodiscard]] auto output_size(size_t n) const -> size_t {
+    return n * factor;
+  }
+
+  // Forget the carried history (start of a new signal)
+  void reset() { buf.assign(hist, T{}); }
+
+  // output.size() must be >= input.size() * factor
+  void process(std::span<const T> input, std::span<T> output) {
+    const size_t n = input.size();
+    if (output.size() < n * factor) {
+      throw std::invalid_argument(
+          "Output span size is too small for the input chunk");
+    }
+
+    buf.resize(hist + n);
+    std::copy(input.begin(), input.end(), buf.begin() + hist);
+    branch.resize(n);
+
+    using Ops = simd::Native<T>;
+    for (size_t p = 0; p < factor; ++p) {
+      const auto &taps = branches[p];
+      const size_t q = taps.size();
+      if (q == 0) {
+        for (size_t m = 0; m < n; ++m) { output[m * factor + p] = T{}; }
+        continue;
+      }
+
+      // branch[m] = sum_i taps_p[i] * x[m - i]
+      simd::conv1d_valid_blocked<Ops, simd::BLOCKS>(
+          buf.data() + (hist + 1 - q), n, taps.data(), q, branch.data());
+      for (size_t m = 0; m < n; ++m) { output[m * factor + p] = branch[m]; }
+    }
+
+    std::copy(buf.end() - static_cast<std::ptrdiff_t>(hist), buf.end(),
+              buf.begin());
+    buf.resize(hist);
+  }
+};
+
+// NOLINTEND(*-pointer-arithmetic)
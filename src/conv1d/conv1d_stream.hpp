@@ -0,0 +1,91 @@
+#pragma once
+
+#include "conv1d.hpp"
+#include "conv1d_fft.hpp"
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// NOLINTBEGIN(*-pointer-arithmetic)
+
+enum class StreamPath { Auto, Direct, FFT };
+
+/**
+Stateful FIR filter for chunked input.
+
+Keeps the last `kernel.size() - 1` input samples between `process` calls, so
+feeding a signal in consecutive blocks gives exactly the same output as
+filtering it in one go (the first input.size() samples of a "full"
+convolution). Short kernels run a direct dot-product path, long kernels an
+FFTW overlap-save path.
+*/
+template <conv1d_fftw::Floating T> struct StreamingConv1d {
+  // Kernels longer than this use the overlap-save path with StreamPath::Auto
+  static constexpr size_t fft_threshold = 64;
+
+  std::vector<T> kernel_rev; // reversed kernel for the direct path
+  std::vector<T> history;    // last k - 1 input samples
+  std::vector<T> scratch;    // history + current chunk (direct path)
+  std::unique_ptr<OverlapSave<T>> fft;
+
+  explicit StreamingConv1d(std::span<const T> kernel,
+                           StreamPath path = StreamPath::Auto)
+      : kernel_rev(kernel.rbegin(), kernel.rend()) {
+    if (kernel.empty()) {
+      throw std::invalid_argument("Kernel must not be empty");
+    }
+    history.assign(kernel.size() - 1, T{});
+
+    if (path == StreamPath::FFT ||
+        (path == StreamPath::Auto && kernel.size() > fft_threshold)) {
+      fft = std::make_unique<OverlapSave<T>>(kernel,
+                                             next_pow2(4 * kernel.size()));
+    }
+  }
+
+  [[nodiscard]] auto uses_fft() const -> bool { return fft != nullptr; }
+
+  // Forget the carried history (start of a new signal)
+  void reset() { std::fill(history.begin(), history.end(), T{}); }
+
+  // output.size() must be >= input.size()
+  void process(std::span<const T> input, std::span<T> output) {
+    if (output.size() < input.size()) {
+      throw std::invalid_argument(
+          "Output span size is too small for the input chunk");
+    }
+
+    if (fft) {
+      const size_t block = fft->block_size();
+      for (size_t i = 0; i < input.size(); i += block) {
+        const auto chunk = input.subspan(i, std::min(block, input.size() - i));
+        fft->process(history, chunk, output.data() + i);
+        push_history(chunk);
+      }
+    } else {
+      const size_t m = input.size();
+      scratch.resize(history.size() + m);
+      std::copy(history.begin(), history.end(), scratch.begin());
+      std::copy(input.begin(), input.end(), scratch.begin() + history.size());
+
+      conv1d_eigen<T>(scratch, kernel_rev, output.first(m));
+      push_history(input);
+    }
+  }
+
+private:
+  void push_history(std::span<const T> chunk) {
+    const size_t h = history.size();
+    if (chunk.size() >= h) {
+      std::copy(chunk.end() - h, chunk.end(), history.begin());
+    } else {
+      std::copy(history.begin() + chunk.size(), history.end(),
+                history.begin());
+      std::copy(chunk.begin(), chunk.end(), history.end() - chunk.size());
+    }
+  }
+};
+
+// NOLINTEND(*-pointer-arithmetic)
@@ -1,4 +1,14 @@
 #include "conv1d.hpp"
+#include "conv1d_auto.hpp"
+#include "conv1d_batch.hpp"
+#include "conv1d_complex.hpp"
+#include "conv1d_fft.hpp"
+#include "conv1d_half.hpp"
+#include "conv1d_int16.hpp"
+#include "conv1d_parallel.hpp"
+#include "conv1d_partitioned.hpp"
+#include "conv1d_polyphase.hpp"
+#include "conv1d_stream.hpp"
 #include "fftconv.hpp"
 #include <fftw3.h>
 
@@ -104,6 +114,27 @@ int main(int argc, char *argv[]) {
     fmt::println("Output: {}", fmt::join(output, ", "));
   }
 
+  {
+    std::vector<T> output(output_size_full, 0);
+    conv1d_simd<T, ConvMode::Full>(input, kernel, output);
+    fmt::println("=== SIMD (full) ===");
+    fmt::println("Output: {}", fmt::join(output, ", "));
+  }
+
+  {
+    std::vector<T> output(output_size_same, 0);
+    conv1d_simd<T, ConvMode::Same>(input, kernel, output);
+    fmt::println("=== SIMD (same) ===");
+    fmt::println("Output: {}", fmt::join(output, ", "));
+  }
+
+  {
+    std::vector<T> output(output_size_valid, 0);
+    conv1d_simd<T, ConvMode::Valid>(input, kernel, output);
+    fmt::println("=== SIMD (valid) ===");
+    fmt::println("Output: {}", fmt::join(output, ", "));
+  }
+
   {
     // TODO run ASAN
     std::vector<T> output(output_size_same, 0);
@@ -112,6 +143,177 @@ int main(int argc, char *argv[]) {
     fmt::println("Output: {}", fmt::join(output, ", "));
   }
 
+  {
+    std::vector<T> output(output_size_full, 0);
+    conv1d_auto<T, ConvMode::Full>(input, kernel, output);
+    const auto backend =
+        conv1d_auto_backend<T, ConvMode::Full>(input.size(), kernel.size());
+    fmt::println("=== Auto (full, picked {}) ===", to_string(backend));
+    fmt::println("Output: {}", fmt::join(output, ", "));
+  }
+
+  {
+    std::vector<T> output(output_size_same, 0);
+    conv1d_auto<T, ConvMode::Same>(input, kernel, output);
+    const auto backend =
+        conv1d_auto_backend<T, ConvMode::Same>(input.size(), kernel.size());
+    fmt::println("=== Auto (same, picked {}) ===", to_string(backend));
+    fmt::println("Output: {}", fmt::join(output, ", "));
+  }
+
+  {
+    std::vector<T> output(output_size_valid, 0);
+    conv1d_auto<T, ConvMode::Valid>(input, kernel, output);
+    const auto backend =
+        conv1d_auto_backend<T, ConvMode::Valid>(input.size(), kernel.size());
+    fmt::println("=== Auto (valid, picked {}) ===", to_string(backend));
+    fmt::println("Output: {}", fmt::join(output, ", "));
+  }
+
+  {
+    // Bank of two kernels: `kernel` and its reverse, back to back
+    std::vector<T> bank(kernel);
+    bank.insert(bank.end(), kernel.rbegin(), kernel.rend());
+    std::vector<T> output(output_size_same * 2, 0);
+    const std::span<const T> out(output);
+
+    conv1d_bank_simd<T, ConvMode::Same>(input, bank, 2, output);
+    fmt::println("=== Filter bank SIMD (same) ===");
+    fmt::println("Kernel 0: {}", fmt::join(out.first(output_size_same), ", "));
+    fmt::println("Kernel 1: {}", fmt::join(out.last(output_size_same), ", "));
+
+    FFTFilterBank<T> fft_bank(bank, 2);
+    fft_bank.conv<ConvMode::Same>(input, output);
+    fmt::println("=== Filter bank FFT (same) ===");
+    fmt::println("Kernel 0: {}", fmt::join(out.first(output_size_same), ", "));
+    fmt::println("Kernel 1: {}", fmt::join(out.last(output_size_same), ", "));
+  }
+
+  {
+    // Feed the input in chunks of 3; history is carried across calls
+    const std::span<const T> in(input);
+    for (const auto path : {StreamPath::Direct, StreamPath::FFT}) {
+      std::vector<T> output(input.size(), 0);
+      StreamingConv1d<T> conv(kernel, path);
+      for (size_t i = 0; i < input.size(); i += 3) {
+        const auto len = std::min<size_t>(3, input.size() - i);
+        conv.process(in.subspan(i, len), std::span(output).subspan(i, len));
+      }
+      fmt::println("=== Streaming ({}, chunks of 3) ===",
+                   path == StreamPath::FFT ? "FFT" : "direct");
+      fmt::println("Output: {}", fmt::join(output, ", "));
+    }
+  }
+
+  {
+    // Raw int16 samples with a fixed point kernel (taps * 2^-shift)
+    const std::vector<int16_t> input_i16(input.begin(), input.end());
+    const auto q = quantize_kernel<T>(kernel);
+    std::vector<int32_t> output(output_size_full, 0);
+    conv1d_int16<ConvMode::Full>(input_i16, q.taps, output);
+    fmt::println("=== int16 (full, kernel shift {}) ===", q.shift);
+    fmt::println("Output: {}", fmt::join(output, ", "));
+  }
+
+  {
+    // Analytic-style signal x + 1j * x, complex kernel (1 - 1j) * kernel
+    std::vector<std::complex<T>> input_cx(input.size());
+    std::vector<std::complex<T>> kernel_cx(kernel.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+      input_cx[i] = {input[i], input[i]};
+    }
+    for (size_t j = 0; j < kernel.size(); ++j) {
+      kernel_cx[j] = {kernel[j], -kernel[j]};
+    }
+    std::vector<std::complex<T>> output(output_size_full);
+    conv1d_complex<T, ConvMode::Full>(input_cx, kernel_cx, output);
+    std::vector<T> re(output.size());
+    std::vector<T> im(output.size());
+    for (size_t i = 0; i < output.size(); ++i) {
+      re[i] = output[i].real();
+      im[i] = output[i].imag();
+    }
+    fmt::println("=== Complex (full) ===");
+    fmt::println("Real: {}", fmt::join(re, ", "));
+    fmt::println("Imag: {}", fmt::join(im, ", "));
+  }
+
+  {
+    // bfloat16 input and output, fp32 taps and accumulation
+    std::vector<bf16::BFloat16> input_bf16(input.size());
+    std::vector<float> kernel_f32(kernel.begin(), kernel.end());
+    for (size_t i = 0; i < input.size(); ++i) {
+      input_bf16[i] = bf16::BFloat16(static_cast<float>(input[i]));
+    }
+    std::vector<bf16::BFloat16> output(output_size_full);
+    conv1d_simd_storage<bf16::BFloat16, ConvMode::Full>(input_bf16,
+                                                        kernel_f32, output);
+    std::vector<float> output_f32(output.begin(), output.end());
+    fmt::println("=== bfloat16 storage (full) ===");
+    fmt::println("Output: {}", fmt::join(output_f32, ", "));
+  }
+
+  {
+    // Every 2nd sample of the streaming output, and 2x upsampled
+    PolyphaseDecimator<T> dec(kernel, 2);
+    std::vector<T> decimated(dec.output_size(input.size()), 0);
+    dec.process(input, decimated);
+    fmt::println("=== Polyphase decimate by 2 ===");
+    fmt::println("Output: {}", fmt::join(decimated, ", "));
+
+    PolyphaseInterpolator<T> itp(kernel, 2);
+    std::vector<T> interpolated(itp.output_size(input.size()), 0);
+    itp.process(input, interpolated);
+    fmt::println("=== Polyphase interpolate by 2 ===");
+    fmt::println("Output: {}", fmt::join(interpolated, ", "));
+  }
+
+  {
+    // Tiles of 3 output samples, each with a kernel length halo
+    std::vector<T> output(output_size_full, 0);
+    conv1d_parallel<T, ConvMode::Full>(input, kernel, output,
+                                       Conv1dBackend::SIMD, 3);
+    fmt::println("=== Parallel (full, tiles of 3) ===");
+    fmt::println("Output: {}", fmt::join(output, ", "));
+  }
+
+  {
+    // Blocks of 2 samples, kernel split into 2 partitions of 2 taps
+    std::vector<T> output(input.size(), 0);
+    PartitionedConvolver<T> conv(kernel, 2);
+    conv.process(input, output);
+    fmt::println("=== Partitioned (block 2, {} partitions) ===",
+                 conv.partitions);
+    fmt::println("Output: {}", fmt::join(output, ", "));
+  }
+
+  {
+    // 3 channels, interleaved (x, 2x, -x), full mode
+    constexpr size_t C = 3;
+    std::vector<T> batch_in(input.size() * C);
+    for (size_t i = 0; i < input.size(); ++i) {
+      batch_in[i * C + 0] = input[i];
+      batch_in[i * C + 1] = 2 * input[i];
+      batch_in[i * C + 2] = -input[i];
+    }
+    std::vector<T> batch_out(output_size_full * C, 0);
+    conv1d_batch<T, ConvMode::Full>(
+        StridedChannels<const T>::interleaved(batch_in.data(), input.size(),
+                                              C),
+        kernel,
+        StridedChannels<T>::interleaved(batch_out.data(), output_size_full,
+                                        C),
+        BatchStrategy::AcrossChannels);
+    fmt::println("=== Batch (full, 3 interleaved channels) ===");
+    for (size_t c = 0; c < C; ++c) {
+      std::vector<T> ch(output_size_full);
+      for (size_t i = 0; i < output_size_full; ++i) {
+        ch[i] = batch_out[i * C + c];
+      }
+      fmt::println("Channel {}: {}", c, fmt::join(ch, ", "));
+    }
+  }
+
 #ifdef HAS_IPP
 
   {
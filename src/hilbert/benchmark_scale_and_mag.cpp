@@ -3,19 +3,25 @@
 #include "aligned_vector.hpp"
 #include "fftw.hpp"
 
-template <typename T, typename Func>
+template <typename T, typename Out = T, typename Func>
 void ScaleAndMag(benchmark::State &state, Func func) {
   const auto N = state.range(0);
 
   auto *in = fftw::alloc_complex<T>(N);
-  AlignedVector<T> out(N);
+  for (int64_t i = 0; i < N; ++i) {
+    in[i][0] = static_cast<T>(i % 17) - 8;
+    in[i][1] = static_cast<T>(i % 13) - 6;
+  }
+  AlignedVector<Out> out(N);
   const T fct = 0.5;
   func(in, out.data(), N, fct);
   for (auto _ : state) {
     func(in, out.data(), N, fct);
   }
   state.SetItemsProcessed(state.iterations() * state.range(0));
-  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+  // Bytes read and written
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          (sizeof(fftw::Complex<T>) + sizeof(Out)));
 
   fftw::free<T>(in);
 }
@@ -34,6 +40,104 @@ template <typename T> void BM_ScaleAndMag_avx2(benchmark::State &state) {
 BENCHMARK(BM_ScaleAndMag_avx2<float>)->Range(2048, 8192);
 BENCHMARK(BM_ScaleAndMag_avx2<double>)->Range(2048, 8192);
 
+// fp32 math with 16-bit envelope storage, compare bytes/s with <float>
+template <typename Out>
+void BM_ScaleAndMag_avx2_storage(benchmark::State &state) {
+  ScaleAndMag<float, Out>(state, fftw::scale_and_magnitude_avx2<float, Out>);
+}
+BENCHMARK(BM_ScaleAndMag_avx2_storage<fftw::BFloat16>)->Range(2048, 8192);
+#if defined(__FLT16_MAX__)
+BENCHMARK(BM_ScaleAndMag_avx2_storage<_Float16>)->Range(2048, 8192);
+#endif
+
+#endif
+
+// Deinterleaving kernels, from L1 resident to well beyond L3 (8M complex
+// doubles = 128 MiB in)
+#define SCALE_AND_MAG_SIZES RangeMultiplier(8)->Range(2048, 8 << 20)
+
+#if defined(__AVX2__)
+
+template <typename T>
+void BM_ScaleAndMag_avx2_deint(benchmark::State &state) {
+  ScaleAndMag<T>(state, fftw::scale_and_magnitude_avx2_deint<T>);
+}
+BENCHMARK(BM_ScaleAndMag_avx2_deint<float>)->SCALE_AND_MAG_SIZES;
+BENCHMARK(BM_ScaleAndMag_avx2_deint<double>)->SCALE_AND_MAG_SIZES;
+
+// Same sizes for the gather version
+BENCHMARK(BM_ScaleAndMag_avx2<float>)->SCALE_AND_MAG_SIZES;
+BENCHMARK(BM_ScaleAndMag_avx2<double>)->SCALE_AND_MAG_SIZES;
+
+#endif
+
+#if defined(__AVX512F__)
+
+template <typename T> void BM_ScaleAndMag_avx512(benchmark::State &state) {
+  ScaleAndMag<T>(state, fftw::scale_and_magnitude_avx512<T>);
+}
+BENCHMARK(BM_ScaleAndMag_avx512<float>)->SCALE_AND_MAG_SIZES;
+BENCHMARK(BM_ScaleAndMag_avx512<double>)->SCALE_AND_MAG_SIZES;
+
+#endif
+
+#if defined(__ARM_NEON__)
+
+template <typename T> void BM_ScaleAndMag_neon(benchmark::State &state) {
+  ScaleAndMag<T>(state, fftw::scale_and_magnitude_neon<T>);
+}
+BENCHMARK(BM_ScaleAndMag_neon<float>)->SCALE_AND_MAG_SIZES;
+BENCHMARK(BM_ScaleAndMag_neon<double>)->SCALE_AND_MAG_SIZES;
+
 #endif
 
+// Precision modes of the dispatched kernels
+template <typename T, fftw::MagnitudePrecision P>
+void BM_ScaleAndMag_precision(benchmark::State &state) {
+  ScaleAndMag<T>(state, fftw::scale_and_magnitude<T, T, P>);
+}
+BENCHMARK(BM_ScaleAndMag_precision<float, fftw::MagnitudePrecision::Exact>)
+    ->SCALE_AND_MAG_SIZES;
+BENCHMARK(
+    BM_ScaleAndMag_precision<float, fftw::MagnitudePrecision::RsqrtNewton>)
+    ->SCALE_AND_MAG_SIZES;
+BENCHMARK(
+    BM_ScaleAndMag_precision<float, fftw::MagnitudePrecision::AlphaMaxBetaMin>)
+    ->SCALE_AND_MAG_SIZES;
+BENCHMARK(BM_ScaleAndMag_precision<double, fftw::MagnitudePrecision::Exact>)
+    ->SCALE_AND_MAG_SIZES;
+BENCHMARK(
+    BM_ScaleAndMag_precision<double, fftw::MagnitudePrecision::RsqrtNewton>)
+    ->SCALE_AND_MAG_SIZES;
+BENCHMARK(
+    BM_ScaleAndMag_precision<double, fftw::MagnitudePrecision::AlphaMaxBetaMin>)
+    ->SCALE_AND_MAG_SIZES;
+
+template <typename T, fftw::MagnitudePrecision P>
+void BM_ScaleImagAndMag_precision(benchmark::State &state) {
+  const auto N = state.range(0);
+  AlignedVector<T> real(N);
+  AlignedVector<T> imag(N);
+  for (int64_t i = 0; i < N; ++i) {
+    real[i] = static_cast<T>(i % 17) - 8;
+    imag[i] = static_cast<T>(i % 13) - 6;
+  }
+  AlignedVector<T> out(N);
+  for (auto _ : state) {
+    fftw::scale_imag_and_magnitude<T, P>(real.data(), imag.data(), T(0.5), N,
+                                         out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+  state.SetBytesProcessed(state.iterations() * N * 3 * sizeof(T));
+}
+BENCHMARK(BM_ScaleImagAndMag_precision<float, fftw::MagnitudePrecision::Exact>)
+    ->SCALE_AND_MAG_SIZES;
+BENCHMARK(
+    BM_ScaleImagAndMag_precision<float, fftw::MagnitudePrecision::RsqrtNewton>)
+    ->SCALE_AND_MAG_SIZES;
+BENCHMARK(BM_ScaleImagAndMag_precision<
+              float, fftw::MagnitudePrecision::AlphaMaxBetaMin>)
+    ->SCALE_AND_MAG_SIZES;
+
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -1,8 +1,19 @@
 #include "aligned_vector.hpp"
 #include "hilbert.hpp"
+#include <algorithm>
 #include <benchmark/benchmark.h>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
 #include <numbers>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 // NOLINTBEGIN(*-magic-numbers)
 
@@ -38,11 +49,402 @@ template <typename T> void BM_hilbert_fftw_r2c(benchmark::State &state) {
 BENCHMARK(BM_hilbert_fftw_r2c<float>)->DenseRange(2048, 6144, 1024);
 BENCHMARK(BM_hilbert_fftw_r2c<double>)->DenseRange(2048, 6144, 1024);
 
-// template <typename T> void BM_hilbert_fftw_split(benchmark::State &state) {
-//   hilbert_bench<T>(state, hilbert_fftw_split<T>);
-// }
-// BENCHMARK(BM_hilbert_fftw_split<float>)->DenseRange(2048,6144,1024);
-// BENCHMARK(BM_hilbert_fftw_split<double>)->DenseRange(2048,6144,1024);
+// Frame of `lines` lines of length N (column-major): one plan per line
+// (hilbert_fftw_r2c in a loop) vs one howmany plan for the frame
+template <typename T, typename Func>
+void hilbert_frame_bench(benchmark::State &state, Func hilbert_func) {
+  const auto N = state.range(0);
+  const auto lines = state.range(1);
+  AlignedVector<T> in(N * lines);
+  for (int j = 0; j < lines; ++j) {
+    for (int i = 0; i < N; ++i) {
+      in[j * N + i] =
+          std::cos(std::numbers::pi_v<T> * (4 + j % 8) * i / (N - 1));
+    }
+  }
+  AlignedVector<T> out(N * lines);
+
+  hilbert_func(in, out, N);
+  for (auto _ : state) {
+    hilbert_func(in, out, N);
+  }
+
+  state.SetItemsProcessed(state.iterations() * N * lines);
+  state.SetBytesProcessed(state.iterations() * N * lines * sizeof(T));
+}
+
+template <typename T> void BM_hilbert_fftw_r2c_lines(benchmark::State &state) {
+  hilbert_frame_bench<T>(state, [](const auto &x, auto &env, size_t n) {
+    for (size_t j = 0; j < x.size() / n; ++j) {
+      hilbert_fftw_r2c<T>(std::span<const T>(x.data() + j * n, n),
+                          std::span<T>(env.data() + j * n, n));
+    }
+  });
+}
+BENCHMARK(BM_hilbert_fftw_r2c_lines<float>)
+    ->ArgsProduct({{2048, 4096, 6144}, {128, 512}});
+BENCHMARK(BM_hilbert_fftw_r2c_lines<double>)
+    ->ArgsProduct({{2048, 4096, 6144}, {128, 512}});
+
+template <typename T> void BM_hilbert_fftw_batch(benchmark::State &state) {
+  hilbert_frame_bench<T>(state, [](const auto &x, auto &env, size_t n) {
+    hilbert_fftw_batch<T>(x, env, n);
+  });
+}
+BENCHMARK(BM_hilbert_fftw_batch<float>)
+    ->ArgsProduct({{2048, 4096, 6144}, {128, 512}});
+BENCHMARK(BM_hilbert_fftw_batch<double>)
+    ->ArgsProduct({{2048, 4096, 6144}, {128, 512}});
+
+// Thread scaling for a 256 x 4096 frame, one pool worker per thread
+template <typename T> void BM_hilbert_fftw_parallel(benchmark::State &state) {
+  ThreadPool pool(state.range(2));
+  hilbert_fftw_warmup<T>(pool, state.range(0));
+  hilbert_frame_bench<T>(state, [&](const auto &x, auto &env, size_t n) {
+    hilbert_fftw_parallel<T>(pool, x.data(), n, env.data(), n, n,
+                             x.size() / n);
+  });
+}
+void parallel_args(benchmark::internal::Benchmark *b) {
+  const auto max_threads =
+      std::max<int>(1, static_cast<int>(std::thread::hardware_concurrency()));
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    b->Args({4096, 256, threads});
+  }
+  if ((max_threads & (max_threads - 1)) != 0) {
+    b->Args({4096, 256, max_threads});
+  }
+}
+BENCHMARK(BM_hilbert_fftw_parallel<float>)->Apply(parallel_args)->UseRealTime();
+BENCHMARK(BM_hilbert_fftw_parallel<double>)
+    ->Apply(parallel_args)
+    ->UseRealTime();
+
+// In-process FFTW wisdom for T, to plan from scratch and restore afterwards
+template <typename T> auto export_wisdom() -> std::string {
+  const std::lock_guard lock(fftw::planner_mutex());
+  char *w{};
+  if constexpr (std::is_same_v<T, double>) {
+    w = fftw_export_wisdom_to_string();
+  } else {
+    w = fftwf_export_wisdom_to_string();
+  }
+  std::string wisdom(w);
+  std::free(w); // NOLINT(*-no-malloc, *-owning-memory)
+  return wisdom;
+}
+template <typename T> void forget_wisdom() {
+  const std::lock_guard lock(fftw::planner_mutex());
+  if constexpr (std::is_same_v<T, double>) {
+    fftw_forget_wisdom();
+  } else {
+    fftwf_forget_wisdom();
+  }
+}
+template <typename T> void import_wisdom(const std::string &wisdom) {
+  const std::lock_guard lock(fftw::planner_mutex());
+  if constexpr (std::is_same_v<T, double>) {
+    fftw_import_wisdom_from_string(wisdom.c_str());
+  } else {
+    fftwf_import_wisdom_from_string(wisdom.c_str());
+  }
+}
+
+// Cold start latency: 16 new threads each transform one line of a size with
+// no plan and no wisdom yet. Per-thread plans (the old thread_local engines:
+// every thread calls the planner, later ones hit the first one's wisdom) vs
+// the shared registry (one planner call, the other threads look it up). Both
+// variants walk the same sizes, with wisdom forgotten before each iteration.
+template <typename T, bool Shared>
+void BM_cold_start(benchmark::State &state) {
+  constexpr size_t threads = 16;
+  const std::string wisdom = export_wisdom<T>();
+  size_t fresh = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    // Odd multiples of 32, away from the sizes the other benchmarks use
+    const size_t n = 2080 + 64 * fresh++;
+    forget_wisdom<T>();
+    auto pool = std::make_unique<ThreadPool>(threads);
+    state.ResumeTiming();
+
+    pool->run([n](size_t /*worker*/) {
+      if constexpr (Shared) {
+        auto &engine = fftw::EngineR2C1D<T>::get(n);
+        engine.forward();
+        engine.backward();
+      } else {
+        typename fftw::EngineR2C1D<T>::Plans plans(
+            {n, fftw::flags_for<fftw::EngineR2C1D<T>>()});
+        plans.forward.execute();
+        plans.backward.execute();
+      }
+    });
+
+    state.PauseTiming();
+    pool.reset();
+    state.ResumeTiming();
+  }
+  import_wisdom<T>(wisdom);
+}
+BENCHMARK(BM_cold_start<float, false>)->Iterations(2)->UseRealTime();
+BENCHMARK(BM_cold_start<float, true>)->Iterations(2)->UseRealTime();
+BENCHMARK(BM_cold_start<double, false>)->Iterations(2)->UseRealTime();
+BENCHMARK(BM_cold_start<double, true>)->Iterations(2)->UseRealTime();
+
+// First call latency of hilbert_fftw_r2c for a new size: cold (no wisdom, the
+// planner searches at the current rigor) vs warm (wisdom for the size already
+// loaded, as after running fftw_wisdom_warmup). Every iteration takes a size
+// the plan registry has not seen; cold and warm walk interleaved sizes.
+template <typename T, bool Warm> void BM_first_call(benchmark::State &state) {
+  const std::string wisdom = export_wisdom<T>();
+  size_t fresh = 0;
+  AlignedVector<T> x;
+  AlignedVector<T> env;
+  for (auto _ : state) {
+    state.PauseTiming();
+    const size_t n = (Warm ? 6240 : 6176) + 128 * fresh++;
+    x.assign(n, T{1});
+    env.resize(n);
+    if constexpr (Warm) {
+      // Planning n outside the registry leaves its wisdom behind
+      const typename fftw::EngineR2C1D<T>::Plans plans(
+          {n, fftw::flags_for<fftw::EngineR2C1D<T>>()});
+    } else {
+      forget_wisdom<T>();
+    }
+    state.ResumeTiming();
+
+    hilbert_fftw_r2c<T>(x, env);
+  }
+  import_wisdom<T>(wisdom);
+}
+BENCHMARK(BM_first_call<float, false>)
+    ->Iterations(2)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_first_call<float, true>)
+    ->Iterations(2)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_first_call<double, false>)
+    ->Iterations(2)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_first_call<double, true>)
+    ->Iterations(2)
+    ->Unit(benchmark::kMillisecond);
+
+// Random mix of `sizes` line lengths through engine and plan caches of 32
+// entries. The hit rate falls once the mix outgrows the caches, and each miss
+// pays for new buffers and, if the plans were evicted too, a planner call
+// answered from wisdom. Planned with FFTW_MEASURE to keep the warm-up short.
+void BM_cache_size_mix(benchmark::State &state) {
+  using T = float;
+  using Engine = fftw::EngineR2C1D<T>;
+  const auto n_sizes = static_cast<size_t>(state.range(0));
+  const size_t max_entries = fftw::cache_limits().max_entries;
+  const unsigned flags = fftw::engine_flags<Engine>();
+  fftw::cache_limits().max_entries = 32;
+  fftw::engine_flags<Engine>() = FFTW_MEASURE;
+
+  std::vector<size_t> sizes(n_sizes);
+  for (size_t k = 0; k < n_sizes; ++k) {
+    sizes[k] = 512 + 32 * k;
+  }
+  AlignedVector<T> x(sizes.back(), T{1});
+  AlignedVector<T> env(sizes.back());
+  const auto run = [&](size_t n) {
+    hilbert_fftw_r2c<T>(std::span<const T>(x.data(), n),
+                        std::span<T>(env.data(), n));
+  };
+  // Plan every size once so later misses find wisdom
+  for (const size_t n : sizes) {
+    run(n);
+  }
+
+  std::mt19937 rng(42); // NOLINT(*-msc51-cpp)
+  std::uniform_int_distribution<size_t> pick(0, n_sizes - 1);
+  const size_t hits = fftw::cache_counters().hits;
+  const size_t misses = fftw::cache_counters().misses;
+  for (auto _ : state) {
+    run(sizes[pick(rng)]);
+  }
+
+  const auto d_hits =
+      static_cast<double>(fftw::cache_counters().hits - hits);
+  const auto d_misses =
+      static_cast<double>(fftw::cache_counters().misses - misses);
+  state.counters["hit_rate"] = d_hits / (d_hits + d_misses);
+  state.counters["resident_MiB"] =
+      static_cast<double>(fftw::cache_counters().resident_bytes +
+                          fftw::plan_counters().resident_bytes) /
+      (1 << 20);
+
+  fftw::cache_limits().max_entries = max_entries;
+  fftw::engine_flags<Engine>() = flags;
+}
+BENCHMARK(BM_cache_size_mix)->Arg(16)->Arg(32)->Arg(48)->Arg(64)->Arg(128);
+
+// Windowed sinc bandpass with k taps, passband around fs / 8
+template <typename T> AlignedVector<T> bandpass_kernel(const size_t k) {
+  constexpr T pi = std::numbers::pi_v<T>;
+  AlignedVector<T> kernel(k);
+  for (size_t j = 0; j < k; ++j) {
+    const T t = static_cast<T>(j) - static_cast<T>(k - 1) / 2;
+    const T window = T{0.5} - T{0.5} * std::cos(2 * pi * j / (k - 1));
+    const T lowpass = t == 0 ? T{0.25} : std::sin(pi * t / 4) / (pi * t);
+    kernel[j] = 2 * window * lowpass * std::cos(pi * t / 4);
+  }
+  return kernel;
+}
+
+// Bandpass FIR then Hilbert envelope as two stages: direct "same" FIR (zero
+// padded at the edges) into a temporary, then hilbert_fftw_r2c
+template <typename T> void BM_bandpass_two_stage(benchmark::State &state) {
+  const auto kernel = bandpass_kernel<T>(state.range(1));
+  AlignedVector<T> filtered(state.range(0));
+  hilbert_bench<T>(state, [&](const auto &x, auto &env) {
+    const auto n = static_cast<std::ptrdiff_t>(x.size());
+    const auto k = static_cast<std::ptrdiff_t>(kernel.size());
+    const auto pad = (k - 1) / 2;
+    for (std::ptrdiff_t i = 0; i < n; ++i) {
+      const auto lo = std::max<std::ptrdiff_t>(0, pad - i);
+      const auto hi = std::min<std::ptrdiff_t>(k, n + pad - i);
+      T acc{};
+      for (auto j = lo; j < hi; ++j) {
+        acc += x[i + j - pad] * kernel[j];
+      }
+      filtered[i] = acc;
+    }
+    hilbert_fftw_r2c<T>(filtered, env);
+  });
+}
+BENCHMARK(BM_bandpass_two_stage<float>)
+    ->ArgsProduct({{2048, 4096, 6144}, {33, 129}});
+BENCHMARK(BM_bandpass_two_stage<double>)
+    ->ArgsProduct({{2048, 4096, 6144}, {33, 129}});
+
+template <typename T> void BM_bandpass_fused(benchmark::State &state) {
+  const auto kernel = bandpass_kernel<T>(state.range(1));
+  const BandpassEnvelope<T> fused(kernel, state.range(0));
+  hilbert_bench<T>(state,
+                   [&](const auto &x, auto &env) { fused.envelope(x, env); });
+}
+BENCHMARK(BM_bandpass_fused<float>)
+    ->ArgsProduct({{2048, 4096, 6144}, {33, 129}});
+BENCHMARK(BM_bandpass_fused<double>)
+    ->ArgsProduct({{2048, 4096, 6144}, {33, 129}});
+
+// Envelope to 8-bit log compressed display values: separate passes
+// (hilbert_fftw_r2c, max, std::log10, clamp, quantize) vs hilbert_fftw_log
+template <typename T, typename Func>
+void hilbert_log_bench(benchmark::State &state, Func log_func) {
+  const auto N = state.range(0);
+  AlignedVector<T> in(N);
+  for (int i = 0; i < N; ++i) {
+    in[i] = std::cos(std::numbers::pi_v<T> * 4 * i / (N - 1)) *
+            std::exp(T{-4} * i / N);
+  }
+  std::vector<uint8_t> out(N);
+
+  log_func(in, out);
+  for (auto _ : state) {
+    log_func(in, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * N);
+  state.SetBytesProcessed(state.iterations() * N * (sizeof(T) + 1));
+}
+
+template <typename T> void BM_hilbert_log_separate(benchmark::State &state) {
+  AlignedVector<T> env(state.range(0));
+  hilbert_log_bench<T>(state, [&](const auto &x, auto &out) {
+    constexpr T dynamic_range = 60;
+    hilbert_fftw_r2c<T>(x, env);
+    const T max_env = *std::max_element(env.begin(), env.end());
+    for (size_t i = 0; i < env.size(); ++i) {
+      const T db = 20 * std::log10(env[i] / max_env);
+      const T level = std::clamp<T>(
+          255 * (db + dynamic_range) / dynamic_range, 0, 255);
+      out[i] = static_cast<uint8_t>(std::nearbyint(level));
+    }
+  });
+}
+BENCHMARK(BM_hilbert_log_separate<float>)->DenseRange(2048, 6144, 1024);
+BENCHMARK(BM_hilbert_log_separate<double>)->DenseRange(2048, 6144, 1024);
+
+template <typename T> void BM_hilbert_log_fused(benchmark::State &state) {
+  LogCompression<T> lc{.running_max = true};
+  hilbert_log_bench<T>(state, [&](const auto &x, auto &out) {
+    hilbert_fftw_log<T>(x, out, lc);
+  });
+}
+BENCHMARK(BM_hilbert_log_fused<float>)->DenseRange(2048, 6144, 1024);
+BENCHMARK(BM_hilbert_log_fused<double>)->DenseRange(2048, 6144, 1024);
+
+// Prime lengths: exact length (FFTW's generic prime algorithms) vs zero padded
+// to the next 2^a 3^b 5^c 7^d length
+template <typename T> void BM_hilbert_prime_exact(benchmark::State &state) {
+  hilbert_bench<T>(state, hilbert_fftw_r2c<T>);
+}
+BENCHMARK(BM_hilbert_prime_exact<float>)->Arg(2039)->Arg(4093)->Arg(8191);
+BENCHMARK(BM_hilbert_prime_exact<double>)->Arg(2039)->Arg(4093)->Arg(8191);
+
+template <typename T> void BM_hilbert_prime_padded(benchmark::State &state) {
+  hilbert_bench<T>(state, hilbert_fftw_padded<T>);
+}
+BENCHMARK(BM_hilbert_prime_padded<float>)->Arg(2039)->Arg(4093)->Arg(8191);
+BENCHMARK(BM_hilbert_prime_padded<double>)->Arg(2039)->Arg(4093)->Arg(8191);
+
+// Long signals: one padded FFT over the whole signal vs overlap-save blocks
+// (HilbertOverlapSave defaults: 255 taps, 16384 sample blocks). Planned with
+// FFTW_MEASURE, exhaustive planning of multi-million point FFTs takes hours.
+
+// Plans EngineR2C1D<T> with FFTW_MEASURE while in scope
+// NOLINTNEXTLINE(*-special-member-functions)
+template <typename T> struct MeasurePlans {
+  using Engine = fftw::EngineR2C1D<T>;
+  unsigned flags = fftw::engine_flags<Engine>().exchange(FFTW_MEASURE);
+  ~MeasurePlans() { fftw::engine_flags<Engine>() = flags; }
+};
+
+template <typename T> void BM_hilbert_long_padded(benchmark::State &state) {
+  const MeasurePlans<T> measure;
+  hilbert_bench<T>(state, hilbert_fftw_padded<T>);
+}
+BENCHMARK(BM_hilbert_long_padded<float>)
+    ->Arg(1 << 20)
+    ->Arg(5'000'011)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_hilbert_long_padded<double>)
+    ->Arg(1 << 20)
+    ->Arg(5'000'011)
+    ->Unit(benchmark::kMillisecond);
+
+template <typename T>
+void BM_hilbert_long_overlap_save(benchmark::State &state) {
+  // The constructor plans the block FFT, so it runs under MEASURE too
+  const MeasurePlans<T> measure;
+  const HilbertOverlapSave<T> overlap_save;
+  hilbert_bench<T>(state, [&](const auto &x, auto &env) {
+    overlap_save.envelope(x, env);
+  });
+}
+BENCHMARK(BM_hilbert_long_overlap_save<float>)
+    ->Arg(1 << 20)
+    ->Arg(5'000'011)
+    ->Arg(50'000'017)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_hilbert_long_overlap_save<double>)
+    ->Arg(1 << 20)
+    ->Arg(5'000'011)
+    ->Arg(50'000'017)
+    ->Unit(benchmark::kMillisecond);
+
+template <typename T> void BM_hilbert_fftw_split(benchmark::State &state) {
+  hilbert_bench<T>(state, hilbert_fftw_split<T>);
+}
+BENCHMARK(BM_hilbert_fftw_split<float>)->DenseRange(2048, 6144, 1024);
+BENCHMARK(BM_hilbert_fftw_split<double>)->DenseRange(2048, 6144, 1024);
 
 #if defined(HAS_IPP)
 
@@ -3,12 +3,25 @@ A C++ FFTW wrapper
  */
 #pragma once
 
+#include "bfloat16.hpp"
+#include "fftw_planner.hpp"
+#include "lru_cache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <cmath>
 #include <complex>
+#include <cstdint>
 #include <cstdlib>
 #include <fftw3.h>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
 
 #if defined(__AVX2__)
 #include <immintrin.h>
@@ -22,31 +35,92 @@ A C++ FFTW wrapper
 
 namespace fftw {
 
-// const static unsigned int FLAGS = FFTW_ESTIMATE;
-const static unsigned int FLAGS = FFTW_EXHAUSTIVE;
+/**
+Planner rigor for new plans. FFTW_EXHAUSTIVE finds the fastest plans but can
+take seconds per size without wisdom; FFTW_MEASURE or FFTW_ESTIMATE trade
+some speed for a short first call. Read whenever an engine is made, so set it
+at startup (or see engine_flags to set it for one engine type).
+*/
+inline auto planner_flags() -> std::atomic<unsigned> & {
+  static std::atomic<unsigned> flags{FFTW_EXHAUSTIVE};
+  return flags;
+}
+
+// engine_flags value for an engine that follows planner_flags()
+inline constexpr unsigned INHERIT_FLAGS = ~0U;
+
+// Planner flags for engines of type Engine, overriding planner_flags()
+template <class Engine> auto engine_flags() -> std::atomic<unsigned> & {
+  static std::atomic<unsigned> flags{INHERIT_FLAGS};
+  return flags;
+}
+
+template <class Engine> auto flags_for() -> unsigned {
+  const unsigned flags = engine_flags<Engine>().load();
+  return flags == INHERIT_FLAGS ? planner_flags().load() : flags;
+}
+
+// Guards the FFTW planner (plan creation and destruction), which unlike
+// fftw_execute is not thread safe. Held by every Plan factory and ~Plan, so
+// threads that plan concurrently queue up instead of racing in the planner.
+// The same lock as conv1d_fftw's (fftw_planner.hpp).
+inline auto planner_mutex() -> std::mutex & { return fftw_planner::mutex(); }
+
+// Directory of the wisdom files (.fftw_wisdom, .fftwf_wisdom):
+// $FFTW_WISDOM_DIR, or the working directory
+inline auto default_wisdom_dir() -> std::string {
+  const char *dir = std::getenv("FFTW_WISDOM_DIR"); // NOLINT(*-mt-unsafe)
+  return dir != nullptr ? dir : ".";
+}
+
+// Merge the wisdom files in `dir` into the in-process wisdom
+inline void load_wisdom(const std::string &dir) {
+  const std::lock_guard lock(planner_mutex());
+  fftw_import_wisdom_from_filename((dir + "/.fftw_wisdom").c_str());
+  fftwf_import_wisdom_from_filename((dir + "/.fftwf_wisdom").c_str());
+}
+
+// Write the in-process wisdom to the wisdom files in `dir`
+inline void save_wisdom(const std::string &dir) {
+  const std::lock_guard lock(planner_mutex());
+  fftw_export_wisdom_to_filename((dir + "/.fftw_wisdom").c_str());
+  fftwf_export_wisdom_to_filename((dir + "/.fftwf_wisdom").c_str());
+}
 
 // Place this at the beginning of main() and RAII will take care of setting up
-// and tearing down FFTW3 (threads and wisdom)
+// and tearing down FFTW3 (threads and wisdom in `wisdom_dir`)
 // NOLINTNEXTLINE(*-special-member-functions)
 struct WisdomSetup {
-  explicit WisdomSetup(bool threadSafe) {
+  std::string wisdom_dir;
+
+  explicit WisdomSetup(bool threadSafe,
+                       std::string wisdom_dir = default_wisdom_dir())
+      : wisdom_dir(std::move(wisdom_dir)) {
     static bool callSetup = true;
     if (threadSafe && callSetup) {
       fftw_make_planner_thread_safe();
+      fftwf_make_planner_thread_safe();
       callSetup = false;
     }
-    fftw_import_wisdom_from_filename(".fftw_wisdom");
-    fftwf_import_wisdom_from_filename(".fftwf_wisdom");
-  }
-  ~WisdomSetup() {
-    fftw_export_wisdom_to_filename(".fftw_wisdom");
-    fftwf_export_wisdom_to_filename(".fftwf_wisdom");
+    load_wisdom(this->wisdom_dir);
   }
+  ~WisdomSetup() { save_wisdom(wisdom_dir); }
 };
 
 template <typename T>
 concept Floating = std::is_same_v<T, float> || std::is_same_v<T, double>;
 
+// bfloat16 storage, shared with conv1d
+using BFloat16 = bf16::BFloat16;
+
+// Element types real inputs and envelopes may be stored as
+template <typename T>
+concept Storage = Floating<T> || std::is_same_v<T, BFloat16>
+#if defined(__FLT16_MAX__)
+                  || std::is_same_v<T, _Float16>
+#endif
+    ;
+
 template <Floating T> struct Traits {
   using Real = T;
   using Complex = std::complex<T>;
@@ -100,11 +174,13 @@ TEMPLATIZE(void *, malloc, size_t n, n)
 TEMPLATIZE(T *, alloc_real, size_t n, n)
 TEMPLATIZE(Complex<T> *, alloc_complex, size_t n, n)
 TEMPLATIZE(void, free, void *n, n)
+TEMPLATIZE(int, alignment_of, const T *p, const_cast<T *>(p))
 
 TEMPLATIZE(void, destroy_plan, PlanT<T> plan, plan)
 
 #define PLAN_CREATE_METHOD(FUNC, PARAMS, PARAMS_CALL)                          \
   [[nodiscard]] static Plan FUNC(PARAMS) {                                     \
+    const std::lock_guard lock(planner_mutex());                               \
     Plan<T> planner{[&]() {                                                    \
       if constexpr (std::is_same_v<T, double>) {                               \
         return CONCAT(fftw_plan_, FUNC)(PARAMS_CALL);                          \
@@ -141,7 +217,10 @@ template <typename T> struct Plan {
   Plan &operator=(Plan &&) = default;
   explicit Plan(PlanT<T> plan) : plan(std::move(plan)) {}
   ~Plan() {
-    if (plan) { destroy_plan<T>(plan); }
+    if (plan) {
+      const std::lock_guard lock(planner_mutex());
+      destroy_plan<T>(plan);
+    }
   }
 
   /**
@@ -423,40 +502,101 @@ template <typename T> struct Plan {
                       plan COMMA const_cast<T *>(in) COMMA out)
 };
 
-// In memory cache with key type `Key` and value type `Val`
-template <class Key, class Val> auto get_cached(Key key) -> Val * {
-  thread_local std::unordered_map<Key, std::unique_ptr<Val>> cache;
+/**
+Limits of every engine and plan cache, applied per cache: each engine type
+has one cache per thread (get_cached) and one plan registry (get_shared).
+Defaults to 64 entries and 512 MiB. Lowered limits apply at the next miss.
+*/
+inline auto cache_limits() -> CacheLimits & {
+  static CacheLimits limits{.max_entries{64}, .max_bytes{size_t{512} << 20}};
+  return limits;
+}
+
+// Hits, misses, evictions and resident bytes of the thread_local engine
+// caches, summed over all threads and engine types
+inline auto cache_counters() -> CacheCounters & {
+  static CacheCounters counters;
+  return counters;
+}
 
-  auto &val = cache[key];
-  if (val == nullptr) { val = std::make_unique<Val>(key); }
-  return val.get();
+// The same for the shared plan registries (get_shared)
+inline auto plan_counters() -> CacheCounters & {
+  static CacheCounters counters;
+  return counters;
 }
 
-// In memory cache with key type `Key` and value type `Val`
-template <class Key, class Val> auto get_cached_stack(Key key) -> Val & {
-  thread_local std::unordered_map<Key, Val> cache;
+/**
+Thread local LRU cache with key type `Key` and value type `Val`, built as
+Val(key) on a miss. The reference stays valid until a later miss in the same
+cache evicts it.
+*/
+template <class Key, class Val, class Hash = std::hash<Key>>
+auto get_cached(const Key &key) -> Val & {
+  thread_local LruCache<Key, Val, Hash> cache(cache_limits(), cache_counters());
+  return cache.get(key);
+}
+
+// A transform shape and the planner flags it was planned with
+template <typename Shape> struct PlanKey {
+  Shape shape;
+  unsigned flags;
+  bool operator==(const PlanKey &) const = default;
+};
+template <typename Shape, typename ShapeHash = std::hash<Shape>>
+struct PlanKeyHash {
+  auto operator()(const PlanKey<Shape> &key) const noexcept -> size_t {
+    return ShapeHash{}(key.shape) ^ (std::hash<unsigned>{}(key.flags) << 1);
+  }
+};
+
+// Registry entry: owns a Val built from its key, shared with its users
+template <class Val> struct SharedValue {
+  std::shared_ptr<const Val> ptr;
 
-  if (auto it = cache.find(key); it != cache.end()) { return it->second; }
+  template <class Key>
+  explicit SharedValue(const Key &key)
+      : ptr(std::make_shared<const Val>(key)) {}
+  [[nodiscard]] auto bytes() const -> size_t { return resident_bytes_of(*ptr); }
+};
 
-  auto [it, success] =
-      cache.emplace(std::piecewise_construct, std::forward_as_tuple(key),
-                    std::forward_as_tuple(key));
+/**
+Process-wide LRU registry with key type `Key` and value type `Val`, for state
+that all threads share read-only (FFTW plans: fftw_execute and its new-array
+variants are thread safe). A miss constructs Val(key) once under the lock
+while other threads wait for it. Evicted values live on until their last
+user drops its shared_ptr.
+*/
+template <class Key, class Val, class Hash = std::hash<Key>>
+auto get_shared(const Key &key) -> std::shared_ptr<const Val> {
+  // Never destroyed, so it outlives the thread_local engines torn down at exit
+  // NOLINTNEXTLINE(*-owning-memory)
+  static auto &registry = *new LruCache<Key, SharedValue<Val>, Hash>(
+      cache_limits(), plan_counters());
+  static std::mutex mtx;
+
+  const std::lock_guard lock(mtx);
+  return registry.get(key).ptr;
+}
 
-  return it->second;
+// Plans for `key` from the registry
+template <class Plans, class Shape = size_t, class ShapeHash = std::hash<Shape>>
+auto get_shared_plans(PlanKey<Shape> key) -> std::shared_ptr<const Plans> {
+  return get_shared<PlanKey<Shape>, Plans, PlanKeyHash<Shape, ShapeHash>>(key);
 }
 
+// Thread local engine for size n, planned with the engine type's flags
 template <typename Child> struct cache_mixin {
-  // static auto get(size_t n) -> Child & { return *get_cached<size_t,
-  // Child>(n); }
   static auto get(size_t n) -> Child & {
-    return get_cached_stack<size_t, Child>(n);
+    return get_cached<PlanKey<size_t>, Child, PlanKeyHash<size_t>>(
+        {n, flags_for<Child>()});
   }
 };
 
 template <typename T, bool InPlace = false> struct C2CBuffer {
   using Cx = fftw::Complex<T>;
   Cx *in, *out;
-  explicit C2CBuffer(size_t n) {
+  size_t bytes;
+  explicit C2CBuffer(size_t n) : bytes((InPlace ? 1 : 2) * n * sizeof(Cx)) {
     if constexpr (InPlace) {
       in = fftw::alloc_complex<T>(n);
       out = in;
@@ -478,20 +618,28 @@ template <typename T, bool InPlace = false> struct C2CBuffer {
   }
 };
 
+/*
+The real and imag arrays are carved from one allocation at a fixed distance
+(n), because FFTW's new-array execute on a split plan requires the same
+ii - ri and io - ro as when it was planned. Every buffer of a size then fits
+plans made on any other.
+*/
 template <typename T, bool InPlace = false> struct C2CSplitBuffer {
   using Cx = fftw::Complex<T>;
   T *ri, *ii, *ro, *io;
-  explicit C2CSplitBuffer(size_t n) {
+  size_t bytes;
+  explicit C2CSplitBuffer(size_t n)
+      : bytes((InPlace ? 2 : 4) * n * sizeof(T)) {
     if constexpr (InPlace) {
-      ri = fftw::alloc_real<T>(n);
-      ii = fftw::alloc_real<T>(n);
+      ri = fftw::alloc_real<T>(2 * n);
+      ii = ri + n;
       ro = ri;
       io = ii;
     } else {
-      ri = fftw::alloc_real<T>(n);
-      ii = fftw::alloc_real<T>(n);
-      ro = fftw::alloc_real<T>(n);
-      io = fftw::alloc_real<T>(n);
+      ri = fftw::alloc_real<T>(4 * n);
+      ii = ri + n;
+      ro = ri + 2 * n;
+      io = ri + 3 * n;
     }
   }
   C2CSplitBuffer(const C2CSplitBuffer &) = delete;
@@ -500,12 +648,6 @@ template <typename T, bool InPlace = false> struct C2CSplitBuffer {
   C2CSplitBuffer &operator=(C2CSplitBuffer &&) = delete;
   ~C2CSplitBuffer() noexcept {
     if (ri) fftw::free<T>(ri);
-    if (ii) fftw::free<T>(ii);
-
-    if constexpr (!InPlace) {
-      if (ro) fftw::free<T>(ro);
-      if (io) fftw::free<T>(io);
-    }
   }
 };
 
@@ -513,8 +655,10 @@ template <typename T> struct R2CBuffer {
   using Cx = fftw::Complex<T>;
   T *in;
   Cx *out;
+  size_t bytes;
   explicit R2CBuffer(size_t n)
-      : in(fftw::alloc_real<T>(n)), out(fftw::alloc_complex<T>(n / 2 + 1)) {}
+      : in(fftw::alloc_real<T>(n)), out(fftw::alloc_complex<T>(n / 2 + 1)),
+        bytes(n * sizeof(T) + (n / 2 + 1) * sizeof(Cx)) {}
   R2CBuffer(const R2CBuffer &) = delete;
   R2CBuffer(R2CBuffer &&) = delete;
   R2CBuffer &operator=(const R2CBuffer &) = delete;
@@ -525,12 +669,14 @@ template <typename T> struct R2CBuffer {
   }
 };
 
+// Half spectrum at a fixed io - ro, as in C2CSplitBuffer
 template <typename T> struct R2CSplitBuffer {
   using Cx = fftw::Complex<T>;
   T *in, *ro, *io;
+  size_t bytes;
   explicit R2CSplitBuffer(size_t n)
-      : in(fftw::alloc_real<T>(n)), ro(fftw::alloc_real<T>(n / 2 + 1)),
-        io(fftw::alloc_real<T>(n / 2 + 1)) {}
+      : in(fftw::alloc_real<T>(n)), ro(fftw::alloc_real<T>(2 * (n / 2 + 1))),
+        io(ro + (n / 2 + 1)), bytes((n + 2 * (n / 2 + 1)) * sizeof(T)) {}
   R2CSplitBuffer(const R2CSplitBuffer &) = delete;
   R2CSplitBuffer(R2CSplitBuffer &&) = delete;
   R2CSplitBuffer &operator=(const R2CSplitBuffer &) = delete;
@@ -538,28 +684,52 @@ template <typename T> struct R2CSplitBuffer {
   ~R2CSplitBuffer() noexcept {
     if (in) fftw::free<T>(in);
     if (ro) fftw::free<T>(ro);
-    if (io) fftw::free<T>(io);
   }
 };
 
 template <Floating T, bool InPlace = false>
-struct EngineDFT1D : public cache_mixin<EngineDFT1D<T>> {
+struct EngineDFT1D : public cache_mixin<EngineDFT1D<T, InPlace>> {
   using Cx = fftw::Complex<T>;
   using Plan = fftw::Plan<T>;
 
+  struct Plans {
+    C2CBuffer<T> scratch;
+    Plan forward;
+    Plan backward;
+
+    explicit Plans(PlanKey<size_t> key)
+        : scratch(key.shape),
+          forward(Plan::dft_1d(static_cast<int>(key.shape), scratch.in,
+                               scratch.out, FFTW_FORWARD, key.flags)),
+          backward(Plan::dft_1d(static_cast<int>(key.shape), scratch.out,
+                                scratch.in, FFTW_BACKWARD, key.flags)) {}
+    [[nodiscard]] auto bytes() const -> size_t { return scratch.bytes; }
+  };
+
   C2CBuffer<T> buf;
-  Plan plan_forward;
-  Plan plan_backward;
-
-  explicit EngineDFT1D(size_t n)
-      : buf(n),
-        plan_forward(Plan::dft_1d(n, buf.in, buf.out, FFTW_FORWARD, FLAGS)),
-        plan_backward(Plan::dft_1d(n, buf.out, buf.in, FFTW_BACKWARD, FLAGS)){};
-
-  void forward() { plan_forward.execute(); }
-  void forward(const Cx *in, Cx *out) const { plan_forward.execute(in, out); }
-  void backward() { plan_backward.execute(); }
-  void backward(const Cx *in, Cx *out) const { plan_backward.execute(in, out); }
+  std::shared_ptr<const Plans> plans;
+  const Plan &plan_forward;
+  const Plan &plan_backward;
+
+  explicit EngineDFT1D(PlanKey<size_t> key)
+      : EngineDFT1D(key.shape, get_shared_plans<Plans>(key)) {}
+
+  void forward() { forward(buf.in, buf.out); }
+  void forward(const Cx *in, Cx *out) const {
+    plan_forward.execute_dft(in, out);
+  }
+  void backward() { backward(buf.out, buf.in); }
+  void backward(const Cx *in, Cx *out) const {
+    plan_backward.execute_dft(in, out);
+  }
+
+  // Buffer bytes, for the cache accounting
+  [[nodiscard]] auto bytes() const -> size_t { return buf.bytes; }
+
+private:
+  EngineDFT1D(size_t n, std::shared_ptr<const Plans> plans)
+      : buf(n), plans(std::move(plans)), plan_forward(this->plans->forward),
+        plan_backward(this->plans->backward) {}
 };
 
 template <Floating T, bool InPlace = false>
@@ -567,65 +737,272 @@ struct EngineDFTSplit1D : public cache_mixin<EngineDFTSplit1D<T, InPlace>> {
   using Cx = fftw::Complex<T>;
   using Plan = fftw::Plan<T>;
 
+  /*
+  https://fftw.org/fftw3_doc/Guru-Complex-DFTs.html#Guru-Complex-DFTs
+  There is no sign parameter in fftw_plan_guru_split_dft. This function always
+  plans for an FFTW_FORWARD transform. To plan for an FFTW_BACKWARD
+  transform, you can exploit the identity that the backwards DFT is equal to
+  the forwards DFT with the real and imaginary parts swapped.
+  */
+  struct Plans {
+    C2CSplitBuffer<T> scratch;
+    IODim<T> dim;
+    Plan forward;
+    Plan backward;
+
+    explicit Plans(PlanKey<size_t> key)
+        : scratch(key.shape),
+          dim(IODim<T>{.n = static_cast<int>(key.shape), .is = 1, .os = 1}),
+          forward(Plan::guru_split_dft(1, &dim, 0, nullptr, scratch.ri,
+                                       scratch.ii, scratch.ro, scratch.io,
+                                       key.flags)),
+          backward(Plan::guru_split_dft(1, &dim, 0, nullptr, scratch.io,
+                                        scratch.ro, scratch.ii, scratch.ri,
+                                        key.flags)) {}
+    [[nodiscard]] auto bytes() const -> size_t { return scratch.bytes; }
+  };
+
   C2CSplitBuffer<T> buf;
-  IODim<T> dim;
-  Plan plan_forward;
-  Plan plan_backward;
-
-  explicit EngineDFTSplit1D(size_t n)
-      : buf(n), dim(IODim<T>{.n = static_cast<int>(n), .is = 1, .os = 1}),
-        plan_forward(Plan::guru_split_dft(1, &dim, 0, nullptr, buf.ri, buf.ii,
-                                          buf.ro, buf.io, FLAGS)),
-        plan_backward(Plan::guru_split_dft(1, &dim, 0, nullptr, buf.io, buf.ro,
-                                           buf.ii, buf.ri, FLAGS)){
-            /*
-            https://fftw.org/fftw3_doc/Guru-Complex-DFTs.html#Guru-Complex-DFTs
-            There is no sign parameter in fftw_plan_guru_split_dft. This
-            function always plans for an FFTW_FORWARD transform. To plan for an
-            FFTW_BACKWARD transform, you can exploit the identity that the
-            backwards DFT is equal to the forwards DFT with the real and
-            imaginary parts swapped.
-            */
-        };
-
-  void forward() { plan_forward.execute(); }
+  std::shared_ptr<const Plans> plans;
+  const Plan &plan_forward;
+  const Plan &plan_backward;
+
+  explicit EngineDFTSplit1D(PlanKey<size_t> key)
+      : EngineDFTSplit1D(key.shape, get_shared_plans<Plans>(key)) {}
+
+  void forward() { forward(buf.ri, buf.ii, buf.ro, buf.io); }
   void forward(const T *ri, const T *ii, T *ro, T *io) const {
     plan_forward.execute_split_dft(ri, ii, ro, io);
   }
-  void backward() { plan_backward.execute(); }
+  void backward() { backward(buf.ro, buf.io, buf.ri, buf.ii); }
   void backward(const T *ro, const T *io, T *ri, T *ii) const {
-    plan_backward.execute_split_dft(ro, io, ri, ii);
+    // plan_backward is a forward plan with real and imag swapped
+    plan_backward.execute_split_dft(io, ro, ii, ri);
   }
+
+  // Buffer bytes, for the cache accounting
+  [[nodiscard]] auto bytes() const -> size_t { return buf.bytes; }
+
+private:
+  EngineDFTSplit1D(size_t n, std::shared_ptr<const Plans> plans)
+      : buf(n), plans(std::move(plans)), plan_forward(this->plans->forward),
+        plan_backward(this->plans->backward) {}
 };
 
 template <Floating T> struct EngineR2C1D : public cache_mixin<EngineR2C1D<T>> {
   using Cx = fftw::Complex<T>;
   using Plan = fftw::Plan<T>;
 
+  struct Plans {
+    R2CBuffer<T> scratch;
+    Plan forward;
+    Plan backward;
+
+    explicit Plans(PlanKey<size_t> key)
+        : scratch(key.shape),
+          forward(Plan::dft_r2c_1d(static_cast<int>(key.shape), scratch.in,
+                                   scratch.out, key.flags)),
+          backward(Plan::dft_c2r_1d(static_cast<int>(key.shape), scratch.out,
+                                    scratch.in, key.flags)) {}
+    [[nodiscard]] auto bytes() const -> size_t { return scratch.bytes; }
+  };
+
   R2CBuffer<T> buf;
-  Plan plan_forward;
-  Plan plan_backward;
+  std::shared_ptr<const Plans> plans;
+  const Plan &plan_forward;
+  const Plan &plan_backward;
+
+  explicit EngineR2C1D(PlanKey<size_t> key)
+      : EngineR2C1D(key.shape, get_shared_plans<Plans>(key)) {}
+
+  void forward() { forward(buf.in, buf.out); }
+  void forward(const T *in, Cx *out) const {
+    plan_forward.execute_dft_r2c(in, out);
+  }
+  void backward() { backward(buf.out, buf.in); }
+  void backward(const Cx *in, T *out) const {
+    plan_backward.execute_dft_c2r(in, out);
+  }
+
+  // Buffer bytes, for the cache accounting
+  [[nodiscard]] auto bytes() const -> size_t { return buf.bytes; }
+
+private:
+  EngineR2C1D(size_t n, std::shared_ptr<const Plans> plans)
+      : buf(n), plans(std::move(plans)), plan_forward(this->plans->forward),
+        plan_backward(this->plans->backward) {}
+};
+
+/**
+r2c/c2r with the half spectrum in split real/imag arrays (buf.ro, buf.io,
+n / 2 + 1 each), through the guru split plans.
+*/
+template <Floating T>
+struct EngineR2CSplit1D : public cache_mixin<EngineR2CSplit1D<T>> {
+  using Plan = fftw::Plan<T>;
+
+  struct Plans {
+    R2CSplitBuffer<T> scratch;
+    IODim<T> dim;
+    Plan forward;
+    Plan backward;
+
+    explicit Plans(PlanKey<size_t> key)
+        : scratch(key.shape),
+          dim(IODim<T>{.n = static_cast<int>(key.shape), .is = 1, .os = 1}),
+          forward(Plan::guru_split_dft_r2c(1, &dim, 0, nullptr, scratch.in,
+                                           scratch.ro, scratch.io, key.flags)),
+          backward(Plan::guru_split_dft_c2r(1, &dim, 0, nullptr, scratch.ro,
+                                            scratch.io, scratch.in,
+                                            key.flags)) {}
+    [[nodiscard]] auto bytes() const -> size_t { return scratch.bytes; }
+  };
+
+  R2CSplitBuffer<T> buf;
+  std::shared_ptr<const Plans> plans;
+  const Plan &plan_forward;
+  const Plan &plan_backward;
+
+  explicit EngineR2CSplit1D(PlanKey<size_t> key)
+      : EngineR2CSplit1D(key.shape, get_shared_plans<Plans>(key)) {}
+
+  void forward() { forward(buf.in, buf.ro, buf.io); }
+  void forward(const T *in, T *ro, T *io) const {
+    plan_forward.execute_split_dft_r2c(in, ro, io);
+  }
+  void backward() { backward(buf.ro, buf.io, buf.in); }
+  // Overwrites ri and ii
+  void backward(const T *ri, const T *ii, T *out) const {
+    plan_backward.execute_split_dft_c2r(ri, ii, out);
+  }
 
-  explicit EngineR2C1D(size_t n)
-      : buf(n), plan_forward(Plan::dft_r2c_1d(static_cast<int>(n), buf.in,
-                                              buf.out, FLAGS)),
-        plan_backward(
-            Plan::dft_c2r_1d(static_cast<int>(n), buf.out, buf.in, FLAGS)) {}
+  // Buffer bytes, for the cache accounting
+  [[nodiscard]] auto bytes() const -> size_t { return buf.bytes; }
 
-  void forward() { plan_forward.execute(); }
+private:
+  EngineR2CSplit1D(size_t n, std::shared_ptr<const Plans> plans)
+      : buf(n), plans(std::move(plans)), plan_forward(this->plans->forward),
+        plan_backward(this->plans->backward) {}
+};
+
+// Shape of a batch of `howmany` 1D transforms of length `n`
+struct BatchShape {
+  size_t n;
+  size_t howmany;
+  bool operator==(const BatchShape &) const = default;
+};
+struct BatchShapeHash {
+  auto operator()(const BatchShape &s) const noexcept -> size_t {
+    return std::hash<size_t>{}(s.n) ^ (std::hash<size_t>{}(s.howmany) << 1);
+  }
+};
+
+template <typename T> struct R2CBatchBuffer {
+  using Cx = fftw::Complex<T>;
+  T *in;
+  Cx *out;
+  size_t bytes;
+  explicit R2CBatchBuffer(BatchShape shape)
+      : in(fftw::alloc_real<T>(shape.n * shape.howmany)),
+        out(fftw::alloc_complex<T>((shape.n / 2 + 1) * shape.howmany)),
+        bytes(shape.howmany *
+              (shape.n * sizeof(T) + (shape.n / 2 + 1) * sizeof(Cx))) {}
+  R2CBatchBuffer(const R2CBatchBuffer &) = delete;
+  R2CBatchBuffer(R2CBatchBuffer &&) = delete;
+  R2CBatchBuffer &operator=(const R2CBatchBuffer &) = delete;
+  R2CBatchBuffer &operator=(R2CBatchBuffer &&) = delete;
+  ~R2CBatchBuffer() noexcept {
+    if (in) fftw::free<T>(in);
+    if (out) fftw::free<T>(out);
+  }
+};
+
+/**
+`howmany` r2c/c2r transforms of length n in one plan (fftw_plan_many_dft_r2c).
+Line j lives at buf.in + j * n and buf.out + j * (n / 2 + 1).
+*/
+template <Floating T> struct EngineR2C1DMany {
+  using Cx = fftw::Complex<T>;
+  using Plan = fftw::Plan<T>;
+
+  struct Plans {
+    R2CBatchBuffer<T> scratch;
+    Plan forward;
+    Plan backward;
+
+    explicit Plans(PlanKey<BatchShape> key)
+        : scratch(key.shape), forward(plan(key, true, scratch)),
+          backward(plan(key, false, scratch)) {}
+    [[nodiscard]] auto bytes() const -> size_t { return scratch.bytes; }
+  };
+
+  BatchShape shape;
+  R2CBatchBuffer<T> buf;
+  std::shared_ptr<const Plans> plans;
+  const Plan &plan_forward;
+  const Plan &plan_backward;
+
+  explicit EngineR2C1DMany(PlanKey<BatchShape> key)
+      : EngineR2C1DMany(
+            key.shape,
+            get_shared_plans<Plans, BatchShape, BatchShapeHash>(key)) {}
+
+  static auto get(size_t n, size_t howmany) -> EngineR2C1DMany & {
+    return get_cached<PlanKey<BatchShape>, EngineR2C1DMany,
+                      PlanKeyHash<BatchShape, BatchShapeHash>>(
+        {{n, howmany}, flags_for<EngineR2C1DMany>()});
+  }
+
+  void forward() { forward(buf.in, buf.out); }
   void forward(const T *in, Cx *out) const {
     plan_forward.execute_dft_r2c(in, out);
   }
-  void backward() { plan_backward.execute(); }
+  void backward() { backward(buf.out, buf.in); }
   void backward(const Cx *in, T *out) const {
     plan_backward.execute_dft_c2r(in, out);
   }
+
+  // Buffer bytes, for the cache accounting
+  [[nodiscard]] auto bytes() const -> size_t { return buf.bytes; }
+
+private:
+  EngineR2C1DMany(BatchShape shape, std::shared_ptr<const Plans> plans)
+      : shape(shape), buf(shape), plans(std::move(plans)),
+        plan_forward(this->plans->forward),
+        plan_backward(this->plans->backward) {}
+
+  static auto plan(PlanKey<BatchShape> key, bool forward,
+                   R2CBatchBuffer<T> &buf) -> Plan {
+    const int n = static_cast<int>(key.shape.n);
+    const int n_cx = n / 2 + 1;
+    const int howmany = static_cast<int>(key.shape.howmany);
+    if (forward) {
+      return Plan::many_dft_r2c(1, &n, howmany, buf.in, nullptr, 1, n, buf.out,
+                                nullptr, 1, n_cx, key.flags);
+    }
+    return Plan::many_dft_c2r(1, &n, howmany, buf.out, nullptr, 1, n_cx,
+                              buf.in, nullptr, 1, n, key.flags);
+  }
 };
 
 /**
 Helper functions
  */
 
+/**
+Smallest m >= n of the form 2^a 3^b 5^c 7^d, the sizes FFTW has fast
+codelets for
+ */
+inline auto next_fast_size(size_t n) -> size_t {
+  for (size_t m = std::max<size_t>(n, 1);; ++m) {
+    size_t r = m;
+    for (const size_t p : {2, 3, 5, 7}) {
+      while (r % p == 0) { r /= p; }
+    }
+    if (r == 1) { return m; }
+  }
+}
+
 /**
 out[i] += in[i] * fct
  */
@@ -668,12 +1045,236 @@ void magnitude(T const *ri, T const *ii, T *out, size_t len) {
   }
 }
 
+/*
+Precision of the magnitude sqrt(re^2 + im^2) in the envelope kernels
+- Exact: sqrt
+- RsqrtNewton: s * rsqrt(s) with the hardware reciprocal sqrt estimate
+  refined by Newton steps, max relative error ~1e-6 for float and ~1e-12 for
+  double (AVX2 takes the double estimate in float, so s must be in float
+  range)
+- AlphaMaxBetaMin: alpha * max(|re|, |im|) + beta * min(|re|, |im|), no
+  multiply/sqrt of the squares, max relative error 3.96%
+Serial code paths and tails compute RsqrtNewton exactly.
+*/
+enum class MagnitudePrecision { Exact, RsqrtNewton, AlphaMaxBetaMin };
+
+// alpha max + beta min coefficients with the smallest max relative error
+inline constexpr double AMBM_ALPHA = 0.96043387010342;
+inline constexpr double AMBM_BETA = 0.39782473475849;
+
+template <MagnitudePrecision P, Floating T>
+inline auto magnitude_of(T re, T im) -> T {
+  if constexpr (P == MagnitudePrecision::AlphaMaxBetaMin) {
+    const T a = std::abs(re);
+    const T b = std::abs(im);
+    return static_cast<T>(AMBM_ALPHA) * std::max(a, b) +
+           static_cast<T>(AMBM_BETA) * std::min(a, b);
+  } else {
+    return std::sqrt(re * re + im * im);
+  }
+}
+
+#if defined(__AVX2__)
+
+// Magnitude of 8 (re, im) float pairs
+template <MagnitudePrecision P>
+inline auto magnitude_ps(__m256 re, __m256 im) -> __m256 {
+  if constexpr (P == MagnitudePrecision::AlphaMaxBetaMin) {
+    const auto abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const auto a = _mm256_and_ps(re, abs_mask);
+    const auto b = _mm256_and_ps(im, abs_mask);
+    return _mm256_fmadd_ps(
+        _mm256_set1_ps(AMBM_ALPHA), _mm256_max_ps(a, b),
+        _mm256_mul_ps(_mm256_set1_ps(AMBM_BETA), _mm256_min_ps(a, b)));
+  } else {
+    const auto sum2 = _mm256_fmadd_ps(im, im, _mm256_mul_ps(re, re));
+    if constexpr (P == MagnitudePrecision::Exact) {
+      return _mm256_sqrt_ps(sum2);
+    } else {
+      // _mm256_rsqrt_ps has relative error <= 1.5 * 2^-12, one Newton step
+      // r' = r * (1.5 - 0.5 * s * r^2) squares it
+      auto r = _mm256_rsqrt_ps(sum2);
+      const auto half = _mm256_mul_ps(sum2, _mm256_set1_ps(0.5F));
+      r = _mm256_mul_ps(r, _mm256_fnmadd_ps(half, _mm256_mul_ps(r, r),
+                                            _mm256_set1_ps(1.5F)));
+      // sqrt(s) = s * rsqrt(s), 0 where s == 0 (rsqrt(0) = inf)
+      const auto nonzero =
+          _mm256_cmp_ps(sum2, _mm256_setzero_ps(), _CMP_NEQ_OQ);
+      return _mm256_and_ps(_mm256_mul_ps(sum2, r), nonzero);
+    }
+  }
+}
+
+// Magnitude of 4 (re, im) double pairs
+template <MagnitudePrecision P>
+inline auto magnitude_pd(__m256d re, __m256d im) -> __m256d {
+  if constexpr (P == MagnitudePrecision::AlphaMaxBetaMin) {
+    const auto abs_mask =
+        _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffff));
+    const auto a = _mm256_and_pd(re, abs_mask);
+    const auto b = _mm256_and_pd(im, abs_mask);
+    return _mm256_fmadd_pd(
+        _mm256_set1_pd(AMBM_ALPHA), _mm256_max_pd(a, b),
+        _mm256_mul_pd(_mm256_set1_pd(AMBM_BETA), _mm256_min_pd(a, b)));
+  } else {
+    const auto sum2 = _mm256_fmadd_pd(im, im, _mm256_mul_pd(re, re));
+    if constexpr (P == MagnitudePrecision::Exact) {
+      return _mm256_sqrt_pd(sum2);
+    } else {
+      // No double rsqrt before AVX-512: estimate in float like
+      // cos_normalize_f64_avx2, then two Newton steps in double
+      auto r = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(sum2)));
+      const auto half = _mm256_mul_pd(sum2, _mm256_set1_pd(0.5));
+      const auto three_halves = _mm256_set1_pd(1.5);
+      r = _mm256_mul_pd(
+          r, _mm256_fnmadd_pd(half, _mm256_mul_pd(r, r), three_halves));
+      r = _mm256_mul_pd(
+          r, _mm256_fnmadd_pd(half, _mm256_mul_pd(r, r), three_halves));
+      const auto nonzero =
+          _mm256_cmp_pd(sum2, _mm256_setzero_pd(), _CMP_NEQ_OQ);
+      return _mm256_and_pd(_mm256_mul_pd(sum2, r), nonzero);
+    }
+  }
+}
+
+#endif
+
+#if defined(__AVX512F__)
+
+// Magnitude of 16 (re, im) float pairs
+template <MagnitudePrecision P>
+inline auto magnitude_ps(__m512 re, __m512 im) -> __m512 {
+  if constexpr (P == MagnitudePrecision::AlphaMaxBetaMin) {
+    const auto a = _mm512_abs_ps(re);
+    const auto b = _mm512_abs_ps(im);
+    return _mm512_fmadd_ps(
+        _mm512_set1_ps(AMBM_ALPHA), _mm512_max_ps(a, b),
+        _mm512_mul_ps(_mm512_set1_ps(AMBM_BETA), _mm512_min_ps(a, b)));
+  } else {
+    const auto sum2 = _mm512_fmadd_ps(im, im, _mm512_mul_ps(re, re));
+    if constexpr (P == MagnitudePrecision::Exact) {
+      return _mm512_sqrt_ps(sum2);
+    } else {
+      // rsqrt14: relative error <= 2^-14, then one Newton step
+      auto r = _mm512_rsqrt14_ps(sum2);
+      const auto half = _mm512_mul_ps(sum2, _mm512_set1_ps(0.5F));
+      r = _mm512_mul_ps(r, _mm512_fnmadd_ps(half, _mm512_mul_ps(r, r),
+                                            _mm512_set1_ps(1.5F)));
+      const auto nonzero =
+          _mm512_cmp_ps_mask(sum2, _mm512_setzero_ps(), _CMP_NEQ_OQ);
+      return _mm512_maskz_mul_ps(nonzero, sum2, r);
+    }
+  }
+}
+
+// Magnitude of 8 (re, im) double pairs
+template <MagnitudePrecision P>
+inline auto magnitude_pd(__m512d re, __m512d im) -> __m512d {
+  if constexpr (P == MagnitudePrecision::AlphaMaxBetaMin) {
+    const auto a = _mm512_abs_pd(re);
+    const auto b = _mm512_abs_pd(im);
+    return _mm512_fmadd_pd(
+        _mm512_set1_pd(AMBM_ALPHA), _mm512_max_pd(a, b),
+        _mm512_mul_pd(_mm512_set1_pd(AMBM_BETA), _mm512_min_pd(a, b)));
+  } else {
+    const auto sum2 = _mm512_fmadd_pd(im, im, _mm512_mul_pd(re, re));
+    if constexpr (P == MagnitudePrecision::Exact) {
+      return _mm512_sqrt_pd(sum2);
+    } else {
+      auto r = _mm512_rsqrt14_pd(sum2);
+      const auto half = _mm512_mul_pd(sum2, _mm512_set1_pd(0.5));
+      const auto three_halves = _mm512_set1_pd(1.5);
+      r = _mm512_mul_pd(
+          r, _mm512_fnmadd_pd(half, _mm512_mul_pd(r, r), three_halves));
+      r = _mm512_mul_pd(
+          r, _mm512_fnmadd_pd(half, _mm512_mul_pd(r, r), three_halves));
+      const auto nonzero =
+          _mm512_cmp_pd_mask(sum2, _mm512_setzero_pd(), _CMP_NEQ_OQ);
+      return _mm512_maskz_mul_pd(nonzero, sum2, r);
+    }
+  }
+}
+
+#endif
+
+#if defined(__ARM_NEON__)
+
+// Magnitude of 4 (re, im) float pairs
+template <MagnitudePrecision P>
+inline auto magnitude_f32(float32x4_t re, float32x4_t im) -> float32x4_t {
+  if constexpr (P == MagnitudePrecision::AlphaMaxBetaMin) {
+    const auto a = vabsq_f32(re);
+    const auto b = vabsq_f32(im);
+    return vfmaq_f32(vmulq_n_f32(vminq_f32(a, b), AMBM_BETA), vmaxq_f32(a, b),
+                     vdupq_n_f32(AMBM_ALPHA));
+  } else {
+    const auto sum2 = vfmaq_f32(vmulq_f32(re, re), im, im);
+    if constexpr (P == MagnitudePrecision::Exact) {
+      return vsqrtq_f32(sum2);
+    } else {
+      // vrsqrte is only ~8 bits accurate: two vrsqrts Newton steps
+      auto r = vrsqrteq_f32(sum2);
+      r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(sum2, r), r));
+      r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(sum2, r), r));
+      const auto zero = vceqzq_f32(sum2);
+      return vreinterpretq_f32_u32(vbicq_u32(
+          vreinterpretq_u32_f32(vmulq_f32(sum2, r)), zero));
+    }
+  }
+}
+
+// Magnitude of 2 (re, im) double pairs
+template <MagnitudePrecision P>
+inline auto magnitude_f64(float64x2_t re, float64x2_t im) -> float64x2_t {
+  if constexpr (P == MagnitudePrecision::AlphaMaxBetaMin) {
+    const auto a = vabsq_f64(re);
+    const auto b = vabsq_f64(im);
+    return vfmaq_f64(vmulq_n_f64(vminq_f64(a, b), AMBM_BETA), vmaxq_f64(a, b),
+                     vdupq_n_f64(AMBM_ALPHA));
+  } else {
+    const auto sum2 = vfmaq_f64(vmulq_f64(re, re), im, im);
+    if constexpr (P == MagnitudePrecision::Exact) {
+      return vsqrtq_f64(sum2);
+    } else {
+      auto r = vrsqrteq_f64(sum2);
+      r = vmulq_f64(r, vrsqrtsq_f64(vmulq_f64(sum2, r), r));
+      r = vmulq_f64(r, vrsqrtsq_f64(vmulq_f64(sum2, r), r));
+      r = vmulq_f64(r, vrsqrtsq_f64(vmulq_f64(sum2, r), r));
+      const auto zero = vceqzq_f64(sum2);
+      return vreinterpretq_f64_u64(vbicq_u64(
+          vreinterpretq_u64_f64(vmulq_f64(sum2, r)), zero));
+    }
+  }
+}
+
+#endif
+
 #if defined(__AVX2__)
 
+// Store 8 fp32 lanes as Out (fp32, fp16 through F16C, or bfloat16)
+template <Storage Out> inline void store_ps(Out *p, __m256 v) {
+  if constexpr (std::is_same_v<Out, float>) {
+    _mm256_storeu_ps(p, v);
+  } else if constexpr (std::is_same_v<Out, BFloat16>) {
+    bf16::store8(p, v);
+  } else {
+#if defined(__F16C__)
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p),
+                     _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT |
+                                            _MM_FROUND_NO_EXC));
+#else
+    alignas(32) float tmp[8];
+    _mm256_store_ps(tmp, v);
+    for (size_t i = 0; i < 8; ++i) { p[i] = static_cast<Out>(tmp[i]); }
+#endif
+  }
+}
+
 // Normalize `in` by `fct` and take the magnitude of a fftw complex array and
 // scale `in` by `fct out = sqrt( in.re^2 + in.im^2 )
-template <Floating T>
-void scale_and_magnitude_avx2(Complex<T> const *in, T *out, size_t const n,
+// A 16-bit `Out` is computed in fp32 and converted on store (T = float only)
+template <Floating T, Storage Out = T>
+void scale_and_magnitude_avx2(Complex<T> const *in, Out *out, size_t const n,
                               const T fct) {
   size_t i = 0;
   constexpr size_t simd_width = 256 / (8 * sizeof(T));
@@ -700,10 +1301,11 @@ void scale_and_magnitude_avx2(Complex<T> const *in, T *out, size_t const n,
       auto mag = _mm256_sqrt_ps(sum2);
 
       // store
-      _mm256_store_ps(&out[i], mag);
+      store_ps(&out[i], mag);
     }
 
-  } else if constexpr (std::is_same_v<T, double>) {
+  } else if constexpr (std::is_same_v<T, double> &&
+                       std::is_same_v<Out, double>) {
     const auto fct_vec = _mm256_set1_pd(fct);
 
     for (; i + simd_width <= n; i += simd_width) {
@@ -723,43 +1325,193 @@ void scale_and_magnitude_avx2(Complex<T> const *in, T *out, size_t const n,
       auto mag = _mm256_sqrt_pd(sum2);
 
       // store
-      _mm256_store_pd(&out[i], mag);
+      _mm256_storeu_pd(&out[i], mag);
     }
   }
 
   for (; i < n; ++i) {
     const auto re = in[i][0] * fct;
     const auto im = in[i][1] * fct;
-    out[i] = std::sqrt(re * re + im * im);
+    out[i] = static_cast<Out>(std::sqrt(re * re + im * im));
   }
 }
 
 #endif
 
-template <Floating T>
-void scale_and_magnitude_serial(Complex<T> const *in, T *out, size_t const len,
-                                const T fct) {
+template <Floating T, Storage Out = T,
+          MagnitudePrecision P = MagnitudePrecision::Exact>
+void scale_and_magnitude_serial(Complex<T> const *in, Out *out,
+                                size_t const len, const T fct) {
   size_t i = 0;
   for (; i < len; ++i) {
     const auto re = in[i][0] * fct;
     const auto im = in[i][1] * fct;
-    out[i] = std::sqrt(re * re + im * im);
+    out[i] = static_cast<Out>(magnitude_of<P>(re, im));
+  }
+}
+
+/*
+Deinterleaving magnitude kernels: out[i] = |fct| * |in[i]|, i.e. the same
+result as scale_and_magnitude_serial with the scale applied once after the
+magnitude, in precision P.
+
+Instead of gathering re and im with per-lane inserts (scale_and_magnitude_avx2
+does 16 _mm256_set_ps inserts per 8 outputs), each iteration does contiguous
+full-width loads of the interleaved array and splits them with two shuffles
+(AVX2), two two-source permutes (AVX-512) or vld2q (NEON). No alignment is
+assumed for `in` or `out`.
+*/
+
+#if defined(__AVX2__)
+
+template <Floating T, Storage Out = T,
+          MagnitudePrecision P = MagnitudePrecision::Exact>
+void scale_and_magnitude_avx2_deint(Complex<T> const *in, Out *out,
+                                    size_t const n, const T fct) {
+  const T *p = &in[0][0];
+  const T scale = std::abs(fct);
+  size_t i = 0;
+
+  if constexpr (std::is_same_v<T, float>) {
+    const auto fct_vec = _mm256_set1_ps(scale);
+    for (; i + 8 <= n; i += 8) {
+      const auto a = _mm256_loadu_ps(p + 2 * i);     // r0 i0 .. r3 i3
+      const auto b = _mm256_loadu_ps(p + 2 * i + 8); // r4 i4 .. r7 i7
+      // Per 128-bit lane: re = r0 r1 r4 r5 | r2 r3 r6 r7, im likewise
+      const auto re = _mm256_shuffle_ps(a, b, 0b10001000);
+      const auto im = _mm256_shuffle_ps(a, b, 0b11011101);
+      const auto mag = _mm256_mul_ps(magnitude_ps<P>(re, im), fct_vec);
+      // Restore the order of the 64-bit pairs
+      const auto ordered = _mm256_castpd_ps(
+          _mm256_permute4x64_pd(_mm256_castps_pd(mag), 0b11011000));
+      store_ps(&out[i], ordered);
+    }
+  } else if constexpr (std::is_same_v<T, double> &&
+                       std::is_same_v<Out, double>) {
+    const auto fct_vec = _mm256_set1_pd(scale);
+    for (; i + 4 <= n; i += 4) {
+      const auto a = _mm256_loadu_pd(p + 2 * i);     // r0 i0 r1 i1
+      const auto b = _mm256_loadu_pd(p + 2 * i + 4); // r2 i2 r3 i3
+      const auto re = _mm256_unpacklo_pd(a, b);      // r0 r2 r1 r3
+      const auto im = _mm256_unpackhi_pd(a, b);      // i0 i2 i1 i3
+      const auto mag = _mm256_mul_pd(magnitude_pd<P>(re, im), fct_vec);
+      _mm256_storeu_pd(&out[i], _mm256_permute4x64_pd(mag, 0b11011000));
+    }
+  }
+
+  for (; i < n; ++i) {
+    out[i] = static_cast<Out>(magnitude_of<P>(in[i][0], in[i][1]) * scale);
+  }
+}
+
+#endif
+
+#if defined(__AVX512F__)
+
+template <Floating T, MagnitudePrecision P = MagnitudePrecision::Exact>
+void scale_and_magnitude_avx512(Complex<T> const *in, T *out, size_t const n,
+                                const T fct) {
+  const T *p = &in[0][0];
+  const T scale = std::abs(fct);
+  size_t i = 0;
+
+  if constexpr (std::is_same_v<T, float>) {
+    const auto fct_vec = _mm512_set1_ps(scale);
+    const auto even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20,
+                                        22, 24, 26, 28, 30);
+    const auto odd = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21,
+                                       23, 25, 27, 29, 31);
+    for (; i + 16 <= n; i += 16) {
+      const auto a = _mm512_loadu_ps(p + 2 * i);
+      const auto b = _mm512_loadu_ps(p + 2 * i + 16);
+      const auto re = _mm512_permutex2var_ps(a, even, b);
+      const auto im = _mm512_permutex2var_ps(a, odd, b);
+      _mm512_storeu_ps(&out[i],
+                       _mm512_mul_ps(magnitude_ps<P>(re, im), fct_vec));
+    }
+  } else {
+    const auto fct_vec = _mm512_set1_pd(scale);
+    const auto even = _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+    const auto odd = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+    for (; i + 8 <= n; i += 8) {
+      const auto a = _mm512_loadu_pd(p + 2 * i);
+      const auto b = _mm512_loadu_pd(p + 2 * i + 8);
+      const auto re = _mm512_permutex2var_pd(a, even, b);
+      const auto im = _mm512_permutex2var_pd(a, odd, b);
+      _mm512_storeu_pd(&out[i],
+                       _mm512_mul_pd(magnitude_pd<P>(re, im), fct_vec));
+    }
+  }
+
+  for (; i < n; ++i) {
+    out[i] = magnitude_of<P>(in[i][0], in[i][1]) * scale;
+  }
+}
+
+#endif
+
+#if defined(__ARM_NEON__)
+
+template <Floating T, MagnitudePrecision P = MagnitudePrecision::Exact>
+void scale_and_magnitude_neon(Complex<T> const *in, T *out, size_t const n,
+                              const T fct) {
+  const T *p = &in[0][0];
+  const T scale = std::abs(fct);
+  size_t i = 0;
+
+  if constexpr (std::is_same_v<T, float>) {
+    for (; i + 4 <= n; i += 4) {
+      const float32x4x2_t z = vld2q_f32(p + 2 * i); // val[0] = re, val[1] = im
+      vst1q_f32(&out[i],
+                vmulq_n_f32(magnitude_f32<P>(z.val[0], z.val[1]), scale));
+    }
+  } else {
+    for (; i + 2 <= n; i += 2) {
+      const float64x2x2_t z = vld2q_f64(p + 2 * i);
+      vst1q_f64(&out[i],
+                vmulq_n_f64(magnitude_f64<P>(z.val[0], z.val[1]), scale));
+    }
+  }
+
+  for (; i < n; ++i) {
+    out[i] = magnitude_of<P>(in[i][0], in[i][1]) * scale;
   }
 }
 
+#endif
+
 // Normalize `in` by `fct` and take the magnitude of a fftw complex array and
 // scale `in` by `fct out = sqrt( in.re^2 + in.im^2 )
-template <Floating T>
-void scale_and_magnitude(Complex<T> const *in, T *out, size_t const len,
+// `Out` may be a 16-bit storage type (_Float16 or BFloat16)
+// P selects an approximate magnitude (see MagnitudePrecision)
+template <Floating T, Storage Out = T,
+          MagnitudePrecision P = MagnitudePrecision::Exact>
+void scale_and_magnitude(Complex<T> const *in, Out *out, size_t const len,
                          const T fct) {
 
-#if defined(__AVX2__)
+#if defined(__AVX512F__)
+
+  if constexpr (std::is_same_v<Out, T>) {
+    scale_and_magnitude_avx512<T, P>(in, out, len, fct);
+  } else {
+    scale_and_magnitude_avx2_deint<T, Out, P>(in, out, len, fct);
+  }
+
+#elif defined(__AVX2__)
+
+  scale_and_magnitude_avx2_deint<T, Out, P>(in, out, len, fct);
 
-  scale_and_magnitude_avx2(in, out, len, fct);
+#elif defined(__ARM_NEON__)
+
+  if constexpr (std::is_same_v<Out, T>) {
+    scale_and_magnitude_neon<T, P>(in, out, len, fct);
+  } else {
+    scale_and_magnitude_serial<T, Out, P>(in, out, len, fct);
+  }
 
 #else
 
-  scale_and_magnitude_serial(in, out, len, fct);
+  scale_and_magnitude_serial<T, Out, P>(in, out, len, fct);
 
 #endif
 }
@@ -777,13 +1529,13 @@ void scale_and_magnitude(T const *ri, T const *ii, T *out, size_t const len,
   }
 }
 
-template <typename T>
+template <typename T, MagnitudePrecision P = MagnitudePrecision::Exact>
 void scale_imag_and_magnitude(T const *real, T const *imag, T fct, size_t n,
                               T *out);
 
 #if defined(__ARM_NEON__)
 
-template <typename T>
+template <typename T, MagnitudePrecision P = MagnitudePrecision::Exact>
 void scale_imag_and_magnitude_neon(T const *real, T const *imag, T fct,
                                    size_t n, T *out) {
 
@@ -796,12 +1548,8 @@ void scale_imag_and_magnitude_neon(T const *real, T const *imag, T fct,
       auto real_vec = vld1q_f32(&real[i]);
       auto imag_vec = vld1q_f32(&imag[i]);
 
-      // Proc first set
       imag_vec = vmulq_f32(imag_vec, fct_vec);
-      real_vec = vmulq_f32(real_vec, real_vec);
-      real_vec = vfmaq_f32(real_vec, imag_vec, imag_vec);
-      auto res = vsqrtq_f32(real_vec);
-      vst1q_f32(&out[i], res);
+      vst1q_f32(&out[i], magnitude_f32<P>(real_vec, imag_vec));
     }
 
   } else if constexpr (std::is_same_v<T, double>) {
@@ -813,19 +1561,13 @@ void scale_imag_and_magnitude_neon(T const *real, T const *imag, T fct,
       auto imag_vec = vld1q_f64(&imag[i]);
 
       imag_vec = vmulq_f64(imag_vec, fct_vec);
-      real_vec = vmulq_f64(real_vec, real_vec);
-      real_vec = vfmaq_f64(real_vec, imag_vec, imag_vec);
-      auto res = vsqrtq_f64(real_vec);
-      vst1q_f64(&out[i], res);
+      vst1q_f64(&out[i], magnitude_f64<P>(real_vec, imag_vec));
     }
   }
 
   // Remaining
   for (; i < n; ++i) {
-    const auto ri = real[i];
-    const auto ii = imag[i] * fct;
-    const auto res = std::sqrt(ri * ri + ii * ii);
-    out[i] = res;
+    out[i] = magnitude_of<P>(real[i], imag[i] * fct);
   }
 }
 
@@ -833,7 +1575,7 @@ void scale_imag_and_magnitude_neon(T const *real, T const *imag, T fct,
 
 #if defined(__AVX2__)
 
-template <typename T>
+template <typename T, MagnitudePrecision P = MagnitudePrecision::Exact>
 void scale_imag_and_magnitude_avx2(T const *real, T const *imag, T fct,
                                    size_t n, T *out) {
   constexpr size_t prefetch_distance = 16;
@@ -851,20 +1593,16 @@ void scale_imag_and_magnitude_avx2(T const *real, T const *imag, T fct,
         _mm_prefetch((const char *)&out[i + prefetch_distance], _MM_HINT_T0);
       }
 
-      auto r_vec = _mm256_load_ps(&real[i]);
-      auto i_vec = _mm256_load_ps(&imag[i]);
+      auto r_vec = _mm256_loadu_ps(&real[i]);
+      auto i_vec = _mm256_loadu_ps(&imag[i]);
 
       i_vec = _mm256_mul_ps(i_vec, fct_vec);
-      r_vec = _mm256_mul_ps(r_vec, r_vec);
-      r_vec = _mm256_fmadd_ps(i_vec, i_vec, r_vec);
-      auto res = _mm256_sqrt_ps(r_vec);
-      _mm256_store_ps(&out[i], res);
+      _mm256_storeu_ps(&out[i], magnitude_ps<P>(r_vec, i_vec));
     }
 
   } else if constexpr (std::is_same_v<T, double>) {
     constexpr size_t simd_width = 256 / (8 * sizeof(double));
     const auto fct_vec = _mm256_set1_pd(fct);
-    constexpr size_t prefetch_distance = 16;
 
     for (; i + simd_width <= n; i += simd_width) {
       if (i + prefetch_distance < n) {
@@ -873,48 +1611,179 @@ void scale_imag_and_magnitude_avx2(T const *real, T const *imag, T fct,
         _mm_prefetch((const char *)&out[i + prefetch_distance], _MM_HINT_T0);
       }
 
-      auto r_vec = _mm256_load_pd(&real[i]);
-      auto i_vec = _mm256_load_pd(&imag[i]);
+      auto r_vec = _mm256_loadu_pd(&real[i]);
+      auto i_vec = _mm256_loadu_pd(&imag[i]);
       i_vec = _mm256_mul_pd(i_vec, fct_vec);
-      r_vec = _mm256_mul_pd(r_vec, r_vec);
-      r_vec = _mm256_fmadd_pd(i_vec, i_vec, r_vec);
-      auto res = _mm256_sqrt_pd(r_vec);
-      _mm256_store_pd(&out[i], res);
+      _mm256_storeu_pd(&out[i], magnitude_pd<P>(r_vec, i_vec));
     }
   }
 
   for (; i < n; ++i) {
-    const auto ri = real[i];
-    const auto ii = imag[i] * fct;
-    const auto res = std::sqrt(ri * ri + ii * ii);
-    out[i] = res;
+    out[i] = magnitude_of<P>(real[i], imag[i] * fct);
   }
 }
 
 #endif
 
-template <typename T>
+template <typename T, MagnitudePrecision P>
 void scale_imag_and_magnitude(T const *real, T const *imag, T fct, size_t n,
                               T *out) {
 
 #if defined(__ARM_NEON__)
 
-  scale_imag_and_magnitude_neon<T>(real, imag, fct, n, out);
+  scale_imag_and_magnitude_neon<T, P>(real, imag, fct, n, out);
 
 #elif defined(__AVX2__)
 
-  scale_imag_and_magnitude_avx2<T>(real, imag, fct, n, out);
+  scale_imag_and_magnitude_avx2<T, P>(real, imag, fct, n, out);
 
 #else
 
-  for (auto i = 0; i < n; ++i) {
-    const auto ri = real[i];
-    const auto ii = imag[i] * fct;
-    const auto res = std::sqrt(ri * ri + ii * ii);
-    out[i] = res;
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = magnitude_of<P>(real[i], imag[i] * fct);
+  }
+
+#endif
+}
+
+/**
+scale_imag_and_magnitude over `howmany` lines of length n, with line j at
+real + j * ld_real, imag + j * ld_imag and out + j * ld_out (column-major
+with leading dimension ld)
+*/
+template <typename T, MagnitudePrecision P = MagnitudePrecision::Exact>
+void scale_imag_and_magnitude_batch(T const *real, size_t ld_real,
+                                    T const *imag, size_t ld_imag, T fct,
+                                    size_t n, size_t howmany, T *out,
+                                    size_t ld_out) {
+  for (size_t j = 0; j < howmany; ++j) {
+    scale_imag_and_magnitude<T, P>(real + j * ld_real, imag + j * ld_imag, fct,
+                                   n, out + j * ld_out);
   }
+}
+
+/*
+Log compression of the envelope to 8-bit display values, fused with the
+magnitude: out = clamp(gain * log2(s) + offset, 0, 255) with
+s = real^2 + (imag * fct)^2. Since 20 * log10(|z|) = 10 * log10(2) * log2(s),
+no sqrt is taken; gain and offset carry the dB scale, reference and dynamic
+range. log2 takes the exponent bits plus a degree 4 polynomial of the
+mantissa (max error 1e-4, i.e. 3e-4 dB). s below FLT_MIN (zero, float
+denormals, double s that underflow the float conversion) maps to 0: the fast
+log2 has no meaningful value there, and a tiny reference would push them to
+full scale.
+*/
+
+// log2(x) for x >= 0, x == 0 gives -127
+inline auto fast_log2(float x) -> float {
+  const auto bits = std::bit_cast<uint32_t>(x);
+  const auto e = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+  const float t = std::bit_cast<float>((bits & 0x7fffffU) | 0x3f800000U) - 1.F;
+  const float p =
+      ((-0.0847943898F * t + 0.325636038F) * t - 0.679961815F) * t +
+      1.4390166F;
+  return e + p * t;
+}
+
+inline auto log_compress_u8(float s, float gain, float offset) -> uint8_t {
+  if (s < std::numeric_limits<float>::min()) { return 0; }
+  const float v = std::clamp(gain * fast_log2(s) + offset, 0.F, 255.F);
+  return static_cast<uint8_t>(std::nearbyint(v));
+}
+
+#if defined(__AVX2__)
+
+inline auto fast_log2_ps(__m256 x) -> __m256 {
+  const __m256i bits = _mm256_castps_si256(x);
+  const __m256 e = _mm256_sub_ps(
+      _mm256_cvtepi32_ps(_mm256_srli_epi32(bits, 23)), _mm256_set1_ps(127.F));
+  const __m256 t = _mm256_sub_ps(
+      _mm256_castsi256_ps(
+          _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x7fffff)),
+                          _mm256_set1_epi32(0x3f800000))),
+      _mm256_set1_ps(1.F));
+  __m256 p = _mm256_set1_ps(-0.0847943898F);
+  p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(0.325636038F));
+  p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(-0.679961815F));
+  p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(1.4390166F));
+  return _mm256_fmadd_ps(p, t, e);
+}
+
+// Quantize 8 lanes of gain * log2(s) + offset to uint8 at out
+inline void log_compress_store(uint8_t *out, __m256 s, __m256 gain,
+                               __m256 offset) {
+  __m256 v = _mm256_fmadd_ps(fast_log2_ps(s), gain, offset);
+  v = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()),
+                    _mm256_set1_ps(255.F));
+  const __m256 tiny = _mm256_cmp_ps(
+      s, _mm256_set1_ps(std::numeric_limits<float>::min()), _CMP_LT_OQ);
+  v = _mm256_andnot_ps(tiny, v);
+  const __m256i q = _mm256_cvtps_epi32(v);
+  const __m128i q16 = _mm_packus_epi32(_mm256_castsi256_si128(q),
+                                       _mm256_extracti128_si256(q, 1));
+  _mm_storel_epi64(reinterpret_cast<__m128i *>(out),
+                   _mm_packus_epi16(q16, q16));
+}
 
 #endif
+
+// Returns max(s) over the line, for running-max normalization
+template <Floating T>
+auto scale_imag_and_log_compress(T const *real, T const *imag, T fct,
+                                 size_t n, float gain, float offset,
+                                 uint8_t *out) -> T {
+  size_t i = 0;
+  T max_s{0};
+
+#if defined(__AVX2__)
+
+  const auto gain_vec = _mm256_set1_ps(gain);
+  const auto offset_vec = _mm256_set1_ps(offset);
+  if constexpr (std::is_same_v<T, float>) {
+    const auto fct_vec = _mm256_set1_ps(fct);
+    auto max_vec = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+      const auto re = _mm256_loadu_ps(&real[i]);
+      const auto im = _mm256_mul_ps(_mm256_loadu_ps(&imag[i]), fct_vec);
+      const auto s = _mm256_fmadd_ps(im, im, _mm256_mul_ps(re, re));
+      max_vec = _mm256_max_ps(max_vec, s);
+      log_compress_store(&out[i], s, gain_vec, offset_vec);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, max_vec);
+    max_s = *std::max_element(lanes, lanes + 8);
+  } else {
+    // s in double, log in float
+    const auto fct_vec = _mm256_set1_pd(fct);
+    auto max_vec = _mm256_setzero_pd();
+    const auto squares = [&](size_t j) {
+      const auto re = _mm256_loadu_pd(&real[j]);
+      const auto im = _mm256_mul_pd(_mm256_loadu_pd(&imag[j]), fct_vec);
+      const auto s = _mm256_fmadd_pd(im, im, _mm256_mul_pd(re, re));
+      max_vec = _mm256_max_pd(max_vec, s);
+      return _mm256_cvtpd_ps(s);
+    };
+    for (; i + 8 <= n; i += 8) {
+      const auto lo = squares(i);
+      const auto hi = squares(i + 4);
+      log_compress_store(&out[i], _mm256_set_m128(hi, lo), gain_vec,
+                         offset_vec);
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, max_vec);
+    max_s = *std::max_element(lanes, lanes + 4);
+  }
+
+#endif
+
+  for (; i < n; ++i) {
+    const T re = real[i];
+    const T im = imag[i] * fct;
+    const T s = re * re + im * im;
+    max_s = std::max(max_s, s);
+    out[i] = log_compress_u8(static_cast<float>(s), gain, offset);
+  }
+  return max_s;
 }
 
 } // namespace fftw
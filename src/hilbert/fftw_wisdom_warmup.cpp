@@ -0,0 +1,87 @@
+/**
+Pre-plan the FFTW engines for a list of sizes and write the wisdom files, so
+the first call for those sizes in a service does not run the planner.
+
+Usage: fftw_wisdom_warmup [-r estimate|measure|patient|exhaustive]
+                          [-o wisdom_dir] [-b lines] n [n ...]
+
+Plans float and double EngineDFT1D, EngineDFTSplit1D, EngineR2C1D and
+EngineR2CSplit1D for every n (and EngineR2C1DMany for n x lines with -b),
+merging with the wisdom already in wisdom_dir ($FFTW_WISDOM_DIR or the
+working directory by default). Run it in the background at deploy time.
+ */
+#include "fftw.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+auto parse_rigor(std::string_view name) -> std::optional<unsigned> {
+  if (name == "estimate") { return FFTW_ESTIMATE; }
+  if (name == "measure") { return FFTW_MEASURE; }
+  if (name == "patient") { return FFTW_PATIENT; }
+  if (name == "exhaustive") { return FFTW_EXHAUSTIVE; }
+  return std::nullopt;
+}
+
+template <fftw::Floating T> void plan_all(size_t n, size_t lines) {
+  fftw::EngineDFT1D<T>::get(n);
+  fftw::EngineDFTSplit1D<T>::get(n);
+  fftw::EngineR2C1D<T>::get(n);
+  fftw::EngineR2CSplit1D<T>::get(n);
+  if (lines > 0) { fftw::EngineR2C1DMany<T>::get(n, lines); }
+}
+
+int usage(const char *prog) {
+  fmt::print(stderr,
+             "Usage: {} [-r estimate|measure|patient|exhaustive] "
+             "[-o wisdom_dir] [-b lines] n [n ...]\n",
+             prog);
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string wisdom_dir = fftw::default_wisdom_dir();
+  size_t lines = 0;
+  std::vector<size_t> sizes;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i]; // NOLINT(*-pointer-arithmetic)
+    const bool has_value = i + 1 < argc;
+    if (arg == "-r" && has_value) {
+      const auto rigor = parse_rigor(argv[++i]); // NOLINT(*-pointer-arithmetic)
+      if (!rigor) { return usage(argv[0]); }
+      fftw::planner_flags() = *rigor;
+    } else if (arg == "-o" && has_value) {
+      wisdom_dir = argv[++i]; // NOLINT(*-pointer-arithmetic)
+    } else if (arg == "-b" && has_value) {
+      // NOLINTNEXTLINE(*-pointer-arithmetic)
+      lines = std::strtoul(argv[++i], nullptr, 10);
+    } else {
+      const size_t n = std::strtoul(arg.data(), nullptr, 10);
+      if (n == 0) { return usage(argv[0]); }
+      sizes.push_back(n);
+    }
+  }
+  if (sizes.empty()) { return usage(argv[0]); }
+
+  fftw::load_wisdom(wisdom_dir);
+  for (const size_t n : sizes) {
+    const auto start = std::chrono::steady_clock::now();
+    plan_all<float>(n, lines);
+    plan_all<double>(n, lines);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    fmt::println("n = {}: {:.3f} s", n, elapsed.count());
+    // Save as we go, so an interrupted run keeps what it planned
+    fftw::save_wisdom(wisdom_dir);
+  }
+}
@@ -1,17 +1,30 @@
 #pragma once
 
 #include "fftw.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <numbers>
 #include <span>
+#include <type_traits>
+#include <vector>
 
 // NOLINTBEGIN(*-pointer-arithmetic, *-magic-numbers)
 
 /**
 @brief Compute the analytic signal, using the Hilbert transform.
+
+The transform runs in T; `x` and `env` may be stored as a 16-bit type S
+(_Float16 or fftw::BFloat16), converted on load and in the magnitude store.
+S is not deduced, so hilbert_fftw<T>(x, env) still takes containers of T.
 */
-template <fftw::Floating T>
-void hilbert_fftw(const std::span<const T> x, const std::span<T> env) {
+template <fftw::Floating T, fftw::Storage S = T>
+void hilbert_fftw(const std::span<const std::type_identity_t<S>> x,
+                  const std::span<std::type_identity_t<S>> env) {
   const auto n = x.size();
   assert(n > 0);
   assert(x.size() == env.size());
@@ -21,7 +34,7 @@ void hilbert_fftw(const std::span<const T> x, const std::span<T> env) {
 
   // Copy input to real buffer
   for (int i = 0; i < n; ++i) {
-    buf.in[i][0] = x[i];
+    buf.in[i][0] = static_cast<T>(x[i]);
     buf.in[i][1] = 0.;
   }
 
@@ -36,10 +49,8 @@ void hilbert_fftw(const std::span<const T> x, const std::span<T> env) {
     buf.out[i][1] *= 2.;
   }
 
-  if (n % 2 == 0) {
-    buf.out[n_half][0] = 0.;
-    buf.out[n_half][1] = 0.;
-  } else {
+  // The Nyquist bin (even n) keeps weight 1, as in scipy.signal.hilbert
+  if (n % 2 != 0) {
     buf.out[n_half][0] *= 2.;
     buf.out[n_half][1] *= 2.;
   }
@@ -55,18 +66,41 @@ void hilbert_fftw(const std::span<const T> x, const std::span<T> env) {
   // Take the abs of the analytic signal
   const T fct = static_cast<T>(1. / n);
 
-  fftw::scale_and_magnitude<T>(buf.in, env.data(), n, fct);
+  fftw::scale_and_magnitude<T, S>(buf.in, env.data(), n, fct);
 }
 
-/**
-@brief Compute the analytic signal, using the Hilbert transform.
+namespace detail {
+
+/*
+Second half of hilbert_transform_r2c: with the spectrum of x in buf.out,
+multiply by -1j and c2r, leaving n * H{x} in buf.in.
 */
 template <fftw::Floating T>
-void hilbert_fftw_r2c(const std::span<const T> x, const std::span<T> env) {
-  const auto n = x.size();
-  assert(n > 0);
-  assert(x.size() == env.size());
+auto hilbert_from_spectrum(fftw::EngineR2C1D<T> &engine, size_t n)
+    -> const T * {
+  fftw::R2CBuffer<T> &buf = engine.buf;
+
+  //  Multiply by 1j
+  const auto cx_size = n / 2 + 1;
+  for (size_t i = 0; i < cx_size; ++i) {
+    const auto re = buf.out[i][0];
+    const auto im = buf.out[i][1];
+    buf.out[i][0] = im;
+    buf.out[i][1] = -re;
+  }
+
+  // Execute c2r fft on modified spectrum
+  engine.backward();
+  return buf.in;
+}
 
+/*
+n * H{x} (the Hilbert transform scaled by n) through the r2c engine for
+x.size(), left in the engine's real buffer: r2c, multiply by -1j, c2r.
+*/
+template <fftw::Floating T>
+auto hilbert_transform_r2c(const std::span<const T> x) -> const T * {
+  const auto n = x.size();
   fftw::EngineR2C1D<T> &engine = fftw::EngineR2C1D<T>::get(n);
   fftw::R2CBuffer<T> &buf = engine.buf;
 
@@ -78,13 +112,166 @@ void hilbert_fftw_r2c(const std::span<const T> x, const std::span<T> env) {
   // // Execute r2c fft
   // engine.forward();
 
-  // Avoid a copy
-  // NOLINTNEXTLINE(*-const-cast)
-  engine.forward(x.data(), buf.out);
+  // Avoid a copy when x has the alignment the plan was made for
+  if (fftw::alignment_of<T>(x.data()) == fftw::alignment_of<T>(buf.in)) {
+    engine.forward(x.data(), buf.out);
+  } else {
+    std::copy(x.begin(), x.end(), buf.in);
+    engine.forward();
+  }
 
-  //  Multiply by 1j
-  const auto cx_size = n / 2 + 1;
-  for (auto i = 0; i < cx_size; ++i) {
+  return hilbert_from_spectrum<T>(engine, n);
+}
+
+} // namespace detail
+
+/**
+@brief Compute the analytic signal, using the Hilbert transform.
+*/
+template <fftw::Floating T>
+void hilbert_fftw_r2c(const std::span<const T> x, const std::span<T> env) {
+  const auto n = x.size();
+  assert(n > 0);
+  assert(x.size() == env.size());
+
+  const T *h = detail::hilbert_transform_r2c<T>(x);
+
+  // Take the abs of the analytic signal
+  const T fct = static_cast<T>(1. / n);
+
+  for (auto i = 0; i < n; ++i) {
+    const auto real = x[i];
+    const auto imag = h[i] * fct;
+    env[i] = std::sqrt(real * real + imag * imag);
+  }
+
+  // fftw::scale_and_magnitude<T>(buf.in, env.data(), n, fct);
+}
+
+/**
+@brief Log compression settings and state for hilbert_fftw_log.
+
+The envelope maps to 20 * log10(env / ref) dB, clamped to
+[-dynamic_range, 0] and quantized linearly to 0..255. ref is `reference`,
+or with `running_max` the largest envelope seen by earlier calls (the first
+call uses its own max). Reset max_envelope to 0 to restart the running max.
+*/
+template <fftw::Floating T> struct LogCompression {
+  T dynamic_range{60};
+  T reference{1};
+  bool running_max{false};
+  T max_envelope{0};
+};
+
+/**
+@brief Hilbert envelope of one line, log compressed to uint8 display values
+(see LogCompression).
+
+Replaces magnitude, 20 * log10(env / max), clamp and quantize passes with one
+pass over the Hilbert transform output: the dB value comes from a fast log2
+of the squared magnitude (no sqrt), and with `running_max` the line's max is
+gathered in the same pass for the next call.
+*/
+template <fftw::Floating T>
+void hilbert_fftw_log(const std::span<const T> x,
+                      const std::span<uint8_t> out, LogCompression<T> &lc) {
+  const auto n = x.size();
+  assert(n > 0);
+  assert(x.size() == out.size());
+  assert(lc.dynamic_range > 0);
+
+  const T *h = detail::hilbert_transform_r2c<T>(x);
+  const T fct = static_cast<T>(1. / n);
+
+  if (lc.running_max && lc.max_envelope <= 0) {
+    // No reference yet: normalize the first line by its own max
+    T max_sq{0};
+    for (size_t i = 0; i < n; ++i) {
+      const T imag = h[i] * fct;
+      max_sq = std::max(max_sq, x[i] * x[i] + imag * imag);
+    }
+    lc.max_envelope = std::sqrt(max_sq);
+  }
+  const T ref = lc.running_max ? lc.max_envelope : lc.reference;
+  if (ref <= 0) {
+    // Nothing to normalize by (reference 0, or a silent first line): black
+    std::fill(out.begin(), out.end(), uint8_t{0});
+    return;
+  }
+
+  // u8 = 255 / DR * (10 * log10(2) * log2(env^2) - 20 * log10(ref) + DR)
+  const double scale = 255. / static_cast<double>(lc.dynamic_range);
+  const auto gain = static_cast<float>(scale * 10. * std::log10(2.));
+  const auto offset = static_cast<float>(
+      scale * (static_cast<double>(lc.dynamic_range) -
+               20. * std::log10(static_cast<double>(ref))));
+
+  const T max_sq = fftw::scale_imag_and_log_compress<T>(
+      x.data(), h, fct, n, gain, offset, out.data());
+  if (lc.running_max) {
+    lc.max_envelope = std::max(lc.max_envelope, std::sqrt(max_sq));
+  }
+}
+
+/**
+@brief Set up the per-thread EngineR2C1D for line length n on every worker
+of `pool`. The first worker makes the shared plans (fftw::get_shared) and
+the rest only allocate their buffers, so calling this once before
+hilbert_fftw_parallel keeps planning and allocation out of the frame loop.
+*/
+template <fftw::Floating T>
+void hilbert_fftw_warmup(ThreadPool &pool, size_t n) {
+  pool.run([n](size_t /*worker*/) { fftw::EngineR2C1D<T>::get(n); });
+}
+
+/**
+@brief Hilbert envelope of a frame of `lines` lines of length n, with the
+lines split across the workers of `pool` (hilbert_fftw_r2c per line).
+
+Same column-major layout as hilbert_fftw_batch. Each worker processes one
+contiguous block of lines with its own thread_local EngineR2C1D.
+*/
+template <fftw::Floating T>
+void hilbert_fftw_parallel(ThreadPool &pool, const T *x, size_t ldx, T *env,
+                           size_t ldenv, size_t n, size_t lines) {
+  assert(n > 0);
+  assert(ldx >= n && ldenv >= n);
+  pool.parallel_for(lines, [&](size_t begin, size_t end) {
+    for (size_t j = begin; j < end; ++j) {
+      hilbert_fftw_r2c<T>(std::span<const T>(x + j * ldx, n),
+                          std::span<T>(env + j * ldenv, n));
+    }
+  });
+}
+
+// Working set per howmany transform in hilbert_fftw_batch (input, spectrum
+// and output of every line in the tile), sized to stay in L2
+#ifndef HILBERT_BATCH_TILE_BYTES
+#define HILBERT_BATCH_TILE_BYTES (256 * 1024)
+#endif
+
+namespace detail {
+
+template <fftw::Floating T>
+void hilbert_fftw_many(const T *x, size_t ldx, T *env, size_t ldenv, size_t n,
+                       size_t lines) {
+  auto &engine = fftw::EngineR2C1DMany<T>::get(n, lines);
+  auto &buf = engine.buf;
+
+  // The new-array execute needs the planned layout and alignment; otherwise
+  // pack the lines into the engine buffer
+  if (ldx == n && fftw::alignment_of<T>(x) == fftw::alignment_of<T>(buf.in)) {
+    engine.forward(x, buf.out);
+  } else {
+    for (size_t j = 0; j < lines; ++j) {
+      std::copy(x + j * ldx, x + j * ldx + n, buf.in + j * n);
+    }
+    engine.forward();
+  }
+
+  //  Multiply by -1j
+  const size_t cx_size = (n / 2 + 1) * lines;
+  for (size_t i = 0; i < cx_size; ++i) {
     const auto re = buf.out[i][0];
     const auto im = buf.out[i][1];
     buf.out[i][0] = im;
@@ -96,62 +283,338 @@ void hilbert_fftw_r2c(const std::span<const T> x, const std::span<T> env) {
 
   // Take the abs of the analytic signal
   const T fct = static_cast<T>(1. / n);
+  fftw::scale_imag_and_magnitude_batch<T>(x, ldx, buf.in, n, fct, n, lines,
+                                          env, ldenv);
+}
 
-  for (auto i = 0; i < n; ++i) {
-    const auto real = x[i];
-    const auto imag = buf.in[i] * fct;
-    env[i] = std::sqrt(real * real + imag * imag);
+} // namespace detail
+
+/**
+@brief Hilbert envelope of `lines` signals of length n with batched
+(howmany) transforms, hilbert_fftw_r2c semantics per line.
+
+Column-major layout as in arma::Mat: line j is x[j * ldx, j * ldx + n) and
+env[j * ldenv, j * ldenv + n), with ldx, ldenv >= n.
+
+The frame is cut into tiles of lines whose working set fits
+HILBERT_BATCH_TILE_BYTES, each transformed by one r2c and one c2r plan
+(cached per (n, tile)). Planning the whole frame as one transform is slower:
+every pass (r2c, -1j, c2r, magnitude) would then stream the frame through
+memory instead of staying in cache.
+*/
+template <fftw::Floating T>
+void hilbert_fftw_batch(const T *x, size_t ldx, T *env, size_t ldenv,
+                        size_t n, size_t lines) {
+  assert(n > 0);
+  assert(ldx >= n && ldenv >= n);
+
+  const size_t line_bytes = 4 * n * sizeof(T);
+  const size_t tile =
+      std::max<size_t>(1, HILBERT_BATCH_TILE_BYTES / line_bytes);
+  for (size_t j = 0; j < lines; j += tile) {
+    detail::hilbert_fftw_many<T>(x + j * ldx, ldx, env + j * ldenv, ldenv, n,
+                                 std::min(tile, lines - j));
   }
+}
 
-  // fftw::scale_and_magnitude<T>(buf.in, env.data(), n, fct);
+/**
+@brief Batched Hilbert envelope of a contiguous column-major frame of lines
+of length n (e.g. arma::Mat with n_rows == n)
+*/
+template <fftw::Floating T>
+void hilbert_fftw_batch(const std::span<const T> x, const std::span<T> env,
+                        size_t n) {
+  assert(n > 0);
+  assert(x.size() % n == 0);
+  assert(x.size() == env.size());
+  hilbert_fftw_batch<T>(x.data(), n, env.data(), n, n, x.size() / n);
 }
+
 /**
-@brief Compute the analytic signal, using the Hilbert transform.
+@brief FIR bandpass followed by the Hilbert envelope, in one forward/inverse
+FFT pair.
+
+env = |analytic(y)|, where y is `kernel` applied to `x` with conv1d "same"
+semantics, y[i] = sum_j x[i + j - (k - 1) / 2] * kernel[j]. The filter is
+circular over the line like the Hilbert transform itself, so the first and
+last k / 2 samples wrap around instead of seeing zero padding.
+
+The kernel spectrum and the one-sided Hilbert weights (1 at DC and Nyquist,
+2 for positive, 0 for negative frequencies) are folded into one spectrum at
+construction. Each line then costs an r2c FFT, one complex multiply over
+n / 2 + 1 bins and a c2c inverse, instead of the filter's FFT pair (or
+direct convolution) plus the Hilbert FFT pair and an intermediate buffer.
+*/
+template <fftw::Floating T> struct BandpassEnvelope {
+  using Cx = fftw::Complex<T>;
+
+  size_t n;
+  Cx *spectrum; // n / 2 + 1 bins
+
+  BandpassEnvelope(std::span<const T> kernel, size_t n)
+      : n(n), spectrum(fftw::alloc_complex<T>(n / 2 + 1)) {
+    const size_t k = kernel.size();
+    assert(k > 0 && k <= n);
+
+    // g[(pad - j) mod n] = kernel[j] turns the correlation into a circular
+    // convolution with g
+    auto &engine = fftw::EngineR2C1D<T>::get(n);
+    auto &buf = engine.buf;
+    const size_t pad = (k - 1) / 2;
+    std::fill(buf.in, buf.in + n, T{});
+    for (size_t j = 0; j < k; ++j) {
+      buf.in[(pad + n - j) % n] = kernel[j];
+    }
+    engine.forward();
+
+    const size_t n_cx = n / 2 + 1;
+    for (size_t i = 0; i < n_cx; ++i) {
+      const T w = (i == 0 || 2 * i == n) ? T{1} : T{2};
+      spectrum[i][0] = buf.out[i][0] * w;
+      spectrum[i][1] = buf.out[i][1] * w;
+    }
+  }
+  BandpassEnvelope(const BandpassEnvelope &) = delete;
+  BandpassEnvelope(BandpassEnvelope &&) = delete;
+  BandpassEnvelope &operator=(const BandpassEnvelope &) = delete;
+  BandpassEnvelope &operator=(BandpassEnvelope &&) = delete;
+  ~BandpassEnvelope() noexcept {
+    if (spectrum) fftw::free<T>(spectrum);
+  }
+
+  void envelope(const std::span<const T> x, const std::span<T> env) const {
+    assert(x.size() == n);
+    assert(env.size() == n);
+
+    auto &r2c = fftw::EngineR2C1D<T>::get(n);
+    std::copy(x.begin(), x.end(), r2c.buf.in);
+    r2c.forward();
+
+    // Filtered one-sided spectrum, negative frequencies stay zero
+    auto &c2c = fftw::EngineDFT1D<T>::get(n);
+    const size_t n_cx = n / 2 + 1;
+    for (size_t i = 0; i < n_cx; ++i) {
+      const auto re = r2c.buf.out[i][0];
+      const auto im = r2c.buf.out[i][1];
+      c2c.buf.out[i][0] = re * spectrum[i][0] - im * spectrum[i][1];
+      c2c.buf.out[i][1] = re * spectrum[i][1] + im * spectrum[i][0];
+    }
+    for (size_t i = n_cx; i < n; ++i) {
+      c2c.buf.out[i][0] = 0.;
+      c2c.buf.out[i][1] = 0.;
+    }
+    c2c.backward();
+
+    const T fct = static_cast<T>(1. / n);
+    fftw::scale_and_magnitude<T>(c2c.buf.in, env.data(), n, fct);
+  }
+};
+
+/**
+@brief Bandpass + Hilbert envelope of one line (see BandpassEnvelope).
+Computes the kernel spectrum on every call; construct a BandpassEnvelope to
+reuse it across lines.
 */
 template <fftw::Floating T>
-void hilbert_fftw_split(const std::span<const T> x, const std::span<T> env) {
+void hilbert_fftw_bandpass(const std::span<const T> x,
+                           const std::span<const T> kernel,
+                           const std::span<T> env) {
+  const BandpassEnvelope<T> fused(kernel, x.size());
+  fused.envelope(x, env);
+}
+
+/**
+@brief Hilbert envelope with x zero padded to the next 2^a 3^b 5^c 7^d length
+(fftw::next_fast_size), for lengths (e.g. primes) that miss FFTW's fast
+codelets.
+
+Padding makes the transform linear rather than circular over x: samples near
+the ends see zeros past the edge instead of the other end of the signal.
+*/
+template <fftw::Floating T>
+void hilbert_fftw_padded(const std::span<const T> x, const std::span<T> env) {
   const size_t n = x.size();
   assert(n > 0);
   assert(x.size() == env.size());
 
-  auto &engine = fftw::EngineDFTSplit1D<T, true>::get(n);
-  auto &buf = engine.buf;
+  const size_t m = fftw::next_fast_size(n);
+  fftw::EngineR2C1D<T> &engine = fftw::EngineR2C1D<T>::get(m);
+  std::copy(x.begin(), x.end(), engine.buf.in);
+  std::fill(engine.buf.in + n, engine.buf.in + m, T{});
+  engine.forward();
+  const T *h = detail::hilbert_from_spectrum<T>(engine, m);
 
-  // Copy input to real buffer
-  std::copy(x.data(), x.data() + n, buf.ri);
-  std::fill(buf.ii, buf.ii + n, 0);
+  const T fct = static_cast<T>(1. / m);
+  fftw::scale_imag_and_magnitude(x.data(), h, fct, n, env.data());
+}
 
-  // Execute r2c fft
-  engine.forward();
+/**
+@brief FIR approximation of the Hilbert transform with `taps` (odd) taps:
+h[k] = 2 / (pi k) for odd k and 0 for even k, k in [-(taps - 1) / 2,
+(taps - 1) / 2], Blackman windowed. Its response approaches -1j sign(w)
+away from DC and Nyquist as taps grows.
+*/
+template <fftw::Floating T>
+auto hilbert_fir_kernel(size_t taps) -> std::vector<T> {
+  assert(taps % 2 == 1);
+  const auto half = static_cast<std::ptrdiff_t>(taps / 2);
+  const double pi = std::numbers::pi;
+  std::vector<T> kernel(taps);
+  for (std::ptrdiff_t k = -half; k <= half; ++k) {
+    if (k % 2 == 0) { continue; }
+    const double t =
+        static_cast<double>(k + half) / static_cast<double>(taps - 1);
+    const double window =
+        0.42 - 0.5 * std::cos(2 * pi * t) + 0.08 * std::cos(4 * pi * t);
+    kernel[k + half] =
+        static_cast<T>(window * 2 / (pi * static_cast<double>(k)));
+  }
+  return kernel;
+}
 
-  // Zero negative frequencies (half-Hermitian to Hermitian conversion)
-  // Double the magnitude of positive frequencies
-  const size_t n_half = n / 2;
+/**
+@brief Hilbert envelope of arbitrarily long signals in bounded memory:
+overlap-save convolution with a truncated FIR Hilbert kernel
+(hilbert_fir_kernel) over blocks of `block` samples.
+
+Each block FFT yields block - taps + 1 output samples, so one r2c/c2r pair
+of size `block` and the kernel spectrum are all the memory it needs,
+whatever the signal length. The signal is zero padded past its ends, and
+accuracy is that of the FIR kernel: good away from DC and Nyquist.
+*/
+template <fftw::Floating T> struct HilbertOverlapSave {
+  using Cx = fftw::Complex<T>;
+
+  size_t taps;
+  size_t block;
+  Cx *spectrum; // block / 2 + 1 bins of the kernel
+
+  explicit HilbertOverlapSave(size_t taps = 255, size_t block = 16384)
+      : taps(taps), block(block),
+        spectrum(fftw::alloc_complex<T>(block / 2 + 1)) {
+    assert(taps % 2 == 1 && taps < block);
+
+    // h[k] at (k mod block), so output j of a block is centered on input j
+    const auto kernel = hilbert_fir_kernel<T>(taps);
+    const size_t half = taps / 2;
+    auto &engine = fftw::EngineR2C1D<T>::get(block);
+    auto &buf = engine.buf;
+    std::fill(buf.in, buf.in + block, T{});
+    for (size_t j = 0; j < taps; ++j) {
+      buf.in[(j + block - half) % block] = kernel[j];
+    }
+    engine.forward();
+    for (size_t i = 0; i < block / 2 + 1; ++i) {
+      spectrum[i][0] = buf.out[i][0];
+      spectrum[i][1] = buf.out[i][1];
+    }
+  }
+  HilbertOverlapSave(const HilbertOverlapSave &) = delete;
+  HilbertOverlapSave(HilbertOverlapSave &&) = delete;
+  HilbertOverlapSave &operator=(const HilbertOverlapSave &) = delete;
+  HilbertOverlapSave &operator=(HilbertOverlapSave &&) = delete;
+  ~HilbertOverlapSave() noexcept {
+    if (spectrum) fftw::free<T>(spectrum);
+  }
 
-  for (auto i = 1; i < n_half; ++i)
-    buf.ro[i] *= 2.0;
+  void envelope(const std::span<const T> x, const std::span<T> env) const {
+    assert(x.size() == env.size());
+    const size_t n = x.size();
+    const size_t half = taps / 2;
+    const size_t valid = block - 2 * half;
+
+    auto &engine = fftw::EngineR2C1D<T>::get(block);
+    auto &buf = engine.buf;
+    const size_t n_cx = block / 2 + 1;
+    const T fct = static_cast<T>(1. / block);
+
+    for (size_t s = 0; s < n; s += valid) {
+      const size_t len = std::min(valid, n - s);
+
+      // Input [s - half, s - half + block), zero outside x
+      const size_t lead = s < half ? half - s : 0;
+      const size_t begin = s + lead - half;
+      const size_t count = std::min(block - lead, n - begin);
+      std::fill(buf.in, buf.in + lead, T{});
+      std::copy(x.begin() + begin, x.begin() + begin + count, buf.in + lead);
+      std::fill(buf.in + lead + count, buf.in + block, T{});
+      engine.forward();
+
+      for (size_t i = 0; i < n_cx; ++i) {
+        const auto re = buf.out[i][0];
+        const auto im = buf.out[i][1];
+        buf.out[i][0] = re * spectrum[i][0] - im * spectrum[i][1];
+        buf.out[i][1] = re * spectrum[i][1] + im * spectrum[i][0];
+      }
+      engine.backward();
+
+      // Outputs [half, half + len) are free of circular wrap-around
+      fftw::scale_imag_and_magnitude(x.data() + s, buf.in + half, fct, len,
+                                     env.data() + s);
+    }
+  }
+};
 
-  for (auto i = 1; i < n_half; ++i) {
-    buf.io[i] *= 2.0;
+// Longest signal hilbert_fftw_any transforms in one (padded) FFT; longer
+// ones go through HilbertOverlapSave
+#ifndef HILBERT_PAD_MAX
+#define HILBERT_PAD_MAX (1 << 20)
+#endif
+
+/**
+@brief Hilbert envelope of a signal of any length: hilbert_fftw_padded up to
+HILBERT_PAD_MAX samples, HilbertOverlapSave (default kernel and block) past
+that.
+*/
+template <fftw::Floating T>
+void hilbert_fftw_any(const std::span<const T> x, const std::span<T> env) {
+  if (x.size() <= HILBERT_PAD_MAX) {
+    hilbert_fftw_padded<T>(x, env);
+  } else {
+    static const HilbertOverlapSave<T> overlap_save;
+    overlap_save.envelope(x, env);
   }
+}
+
+/**
+@brief Compute the analytic signal, using the Hilbert transform.
+
+Same transform as hilbert_fftw_r2c with the half spectrum in split real/imag
+arrays (EngineR2CSplit1D).
+*/
+template <fftw::Floating T>
+void hilbert_fftw_split(const std::span<const T> x, const std::span<T> env) {
+  const size_t n = x.size();
+  assert(n > 0);
+  assert(x.size() == env.size());
 
-  if (n % 2 == 0) {
-    buf.ro[n_half] = 0.;
-    buf.io[n_half] = 0.;
+  fftw::EngineR2CSplit1D<T> &engine = fftw::EngineR2CSplit1D<T>::get(n);
+  fftw::R2CSplitBuffer<T> &buf = engine.buf;
+
+  // Execute r2c fft, avoiding a copy when x has the plan's alignment
+  if (fftw::alignment_of<T>(x.data()) == fftw::alignment_of<T>(buf.in)) {
+    engine.forward(x.data(), buf.ro, buf.io);
   } else {
-    buf.ro[n_half] *= 2.;
-    buf.io[n_half] *= 2.;
+    std::copy(x.begin(), x.end(), buf.in);
+    engine.forward();
   }
 
-  std::fill(buf.ro + n_half + 1, buf.ro + n, 0.);
-  std::fill(buf.io + n_half + 1, buf.io + n, 0.);
+  // Multiply by -1j: (re, im) -> (im, -re). Done in place rather than by
+  // swapping the arrays passed to c2r, which would flip io - ro from what the
+  // plan was made with.
+  const size_t cx_size = n / 2 + 1;
+  for (size_t i = 0; i < cx_size; ++i) {
+    const T re = buf.ro[i];
+    buf.ro[i] = buf.io[i];
+    buf.io[i] = -re;
+  }
 
   // Execute c2r fft on modified spectrum
   engine.backward();
 
   // Take the abs of the analytic signal
   const T fct = static_cast<T>(1. / n);
-  fftw::scale_imag_and_magnitude(x.data(), buf.ii, fct, n, env.data());
+  fftw::scale_imag_and_magnitude(x.data(), buf.in, fct, n, env.data());
 }
 
 #if defined(HAS_IPP)
@@ -167,16 +630,6 @@ void handleIppStatus(IppStatus status) {
 
 namespace detail {
 
-// In memory cache with key type K and value type V
-// additionally accepts a mutex to guard the V constructor
-template <class Key, class Val> auto get_cached(Key key) -> Val * {
-  thread_local std::unordered_map<Key, std::unique_ptr<Val>> cache;
-
-  auto &val = cache[key];
-  if (val == nullptr) { val = std::make_unique<Val>(key); }
-  return val.get();
-}
-
 struct HilbertIppBuf32fc {
   Ipp32fc *y;
   IppsHilbertSpec *pSpec;
@@ -245,13 +698,13 @@ void hilbert_ipp(const std::span<const T> x, const std::span<T> env) {
   IppStatus status;
 
   if constexpr (std::is_same_v<T, float>) {
-    auto &buf = *fftw::get_cached<size_t, detail::HilbertIppBuf32fc>(n);
+    auto &buf = fftw::get_cached<size_t, detail::HilbertIppBuf32fc>(n);
 
     status = ippsHilbert_32f32fc(x.data(), buf.y, buf.pSpec, buf.pBuffer);
     ippsMagnitude_32fc(buf.y, env.data(), n);
 
   } else if constexpr (std::is_same_v<T, double>) {
-    auto &buf = *fftw::get_cached<size_t, detail::HilbertIppBuf64fc>(n);
+    auto &buf = fftw::get_cached<size_t, detail::HilbertIppBuf64fc>(n);
 
     status = ippsHilbert_64f64fc(x.data(), buf.y, buf.pSpec, buf.pBuffer);
     ippsMagnitude_64fc(buf.y, env.data(), n);
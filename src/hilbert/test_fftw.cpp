@@ -1,7 +1,14 @@
+#include "aligned_vector.hpp"
 #include "fftw.hpp"
 #include "hilbert.hpp"
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
 #include <gtest/gtest.h>
+#include <vector>
 
 // NOLINTBEGIN(*-magic-numbers, *-pointer-arithmetic, *-non-private-member-*,
 // *-member-function, *-destructor)
@@ -497,6 +504,97 @@ using SplitFFTEngineTest_float = SplitFFTEngineTest<float>;
 TEST_F(SplitFFTEngineTest_float, BuiltinBuffer) { run_test_builtin_buffer(); }
 TEST_F(SplitFFTEngineTest_float, ExternalBuffer) { run_test_external_buffer(); }
 
+// Magnitude kernels against the serial version, with vector tails and
+// unaligned input/output
+TEST(ScaleAndMagnitude, MatchesSerial) {
+  const auto fn = [&]<typename T>(T tolerance) {
+    const auto check = [&](auto kernel) {
+      for (size_t n : {1, 7, 8, 17, 33, 100}) {
+        for (size_t offset : {0, 1}) {
+          std::vector<T> buf(2 * (n + offset));
+          for (size_t i = 0; i < buf.size(); ++i) {
+            buf[i] = static_cast<T>(std::sin(0.7 * i) * 3);
+          }
+          const auto *in =
+              reinterpret_cast<const fftw::Complex<T> *>(buf.data()) + offset;
+          std::vector<T> expect(n);
+          std::vector<T> out(n + 1);
+          fftw::scale_and_magnitude_serial<T>(in, expect.data(), n, 0.25);
+          kernel(in, out.data() + offset, n, T(0.25));
+          ExpectArraysNear<T>(expect.data(), out.data() + offset, n,
+                              tolerance);
+        }
+      }
+    };
+    check(fftw::scale_and_magnitude<T, T>);
+#if defined(__AVX2__)
+    check(fftw::scale_and_magnitude_avx2<T, T>);
+    check(fftw::scale_and_magnitude_avx2_deint<T, T>);
+#endif
+#if defined(__AVX512F__)
+    check(fftw::scale_and_magnitude_avx512<T>);
+#endif
+#if defined(__ARM_NEON__)
+    check(fftw::scale_and_magnitude_neon<T>);
+#endif
+  };
+
+  fn.template operator()<double>(1e-12);
+  fn.template operator()<float>(1e-5);
+}
+
+// Approximate magnitude modes: max relative error against the exact
+// magnitude, including zeros and a wide dynamic range
+TEST(ScaleAndMagnitude, PrecisionModes) {
+  using P = fftw::MagnitudePrecision;
+  const auto fn = [&]<typename T, P Mode>(double max_rel_err) {
+    const size_t n = 1001;
+    std::vector<T> buf(2 * n);
+    for (size_t i = 0; i < n; ++i) {
+      const double r = std::pow(10., -3. + 6. * i / n); // 1e-3 .. 1e3
+      buf[2 * i] = static_cast<T>(r * std::cos(0.37 * i));
+      buf[2 * i + 1] = static_cast<T>(r * std::sin(0.37 * i));
+    }
+    buf[0] = buf[1] = 0; // |0| must be 0, not NaN
+    const auto *in = reinterpret_cast<const fftw::Complex<T> *>(buf.data());
+    const T fct = 0.5;
+
+    const auto check = [&](const std::vector<T> &out) {
+      EXPECT_EQ(out[0], 0);
+      double worst = 0;
+      for (size_t i = 1; i < n; ++i) {
+        const double re = buf[2 * i] * fct;
+        const double im = buf[2 * i + 1] * fct;
+        const double exact = std::sqrt(re * re + im * im);
+        worst = std::max(worst, std::abs(out[i] - exact) / exact);
+      }
+      EXPECT_LE(worst, max_rel_err);
+    };
+
+    std::vector<T> out(n);
+    fftw::scale_and_magnitude<T, T, Mode>(in, out.data(), n, fct);
+    check(out);
+
+    // Real part unscaled, imaginary part scaled
+    std::vector<T> re(n);
+    std::vector<T> im(n);
+    for (size_t i = 0; i < n; ++i) {
+      re[i] = buf[2 * i] * fct;
+      im[i] = buf[2 * i + 1];
+    }
+    fftw::scale_imag_and_magnitude<T, Mode>(re.data(), im.data(), fct, n,
+                                            out.data());
+    check(out);
+  };
+
+  fn.template operator()<float, P::Exact>(1e-6);
+  fn.template operator()<double, P::Exact>(1e-14);
+  fn.template operator()<float, P::RsqrtNewton>(1e-5);
+  fn.template operator()<double, P::RsqrtNewton>(1e-10);
+  fn.template operator()<float, P::AlphaMaxBetaMin>(0.0397);
+  fn.template operator()<double, P::AlphaMaxBetaMin>(0.0397);
+}
+
 TEST(TestHilbertFFTW, Correct) {
   const auto fn = [&]<typename T>() {
     const std::array<T, 10> inp = {
@@ -517,6 +615,275 @@ TEST(TestHilbertFFTW, Correct) {
   fn.template operator()<float>();
 }
 
+// 16-bit storage against the fp32 envelope, within the storage precision
+TEST(TestHilbertFFTW, HalfStorage) {
+  const auto fn = [&]<typename S>(float tolerance) {
+    alignas(32) const std::array<float, 10> inp = {
+        -0.999984, -0.736924, 0.511211, -0.0826997, 0.0655345,
+        -0.562082, -0.905911, 0.357729, 0.358593,   0.869386,
+    };
+    alignas(32) std::array<float, 10> expect{};
+    hilbert_fftw<float>(inp, expect);
+
+    std::array<S, 10> x{};
+    std::array<S, 10> out{};
+    for (size_t i = 0; i < inp.size(); ++i) { x[i] = static_cast<S>(inp[i]); }
+
+    hilbert_fftw<float, S>(x, out);
+
+    std::array<float, 10> env{};
+    for (size_t i = 0; i < out.size(); ++i) {
+      env[i] = static_cast<float>(out[i]);
+    }
+    ExpectArraysNear<float>(expect.data(), env.data(), expect.size(),
+                            tolerance);
+  };
+
+  fn.template operator()<fftw::BFloat16>(1e-2);
+#if defined(__FLT16_MAX__)
+  fn.template operator()<_Float16>(2e-3);
+#endif
+}
+
+TEST(TestHilbertBandpass, IdentityKernel) {
+  // scipy.signal.hilbert convention: the Nyquist bin is kept
+  const auto fn = [&]<typename T>() {
+    alignas(32) const std::array<T, 10> inp = {
+        -0.999984, -0.736924, 0.511211, -0.0826997, 0.0655345,
+        -0.562082, -0.905911, 0.357729, 0.358593,   0.869386,
+    };
+    const std::array<T, 10> expect = {
+        1.45197493, 1.15365169, 0.54703078, 0.27346519, 0.15097965,
+        0.83696245, 1.1476185,  0.71885109, 0.46089151, 1.07384968};
+    const std::array<T, 1> kernel = {1};
+    alignas(32) std::array<T, 10> out{};
+
+    hilbert_fftw_bandpass<T>(inp, kernel, out);
+
+    ExpectArraysNear<T>(expect.data(), out.data(), expect.size(), 1e-6);
+  };
+
+  fn.template operator()<double>();
+  fn.template operator()<float>();
+}
+
+// Fused pipeline against circular FIR followed by hilbert_fftw_r2c
+TEST(TestHilbertBandpass, MatchesTwoStage) {
+  const auto fn = [&]<typename T>(size_t n, size_t k, T tolerance) {
+    std::vector<T> x(n);
+    std::vector<T> kernel(k);
+    for (size_t i = 0; i < n; ++i) {
+      x[i] = static_cast<T>(std::sin(0.3 * i) + 0.5 * std::cos(1.7 * i));
+    }
+    for (size_t j = 0; j < k; ++j) {
+      kernel[j] = static_cast<T>(std::cos(0.4 * j) / (1. + j));
+    }
+
+    const size_t pad = (k - 1) / 2;
+    AlignedVector<T> y(n);
+    for (size_t i = 0; i < n; ++i) {
+      T acc{};
+      for (size_t j = 0; j < k; ++j) {
+        acc += x[(i + j + n - pad) % n] * kernel[j];
+      }
+      y[i] = acc;
+    }
+    AlignedVector<T> expect(n);
+    hilbert_fftw_r2c<T>(y, expect);
+
+    AlignedVector<T> env(n);
+    BandpassEnvelope<T> fused(kernel, n);
+    fused.envelope(x, env);
+
+    ExpectArraysNear<T>(expect.data(), env.data(), n, tolerance);
+  };
+
+  fn.template operator()<double>(64, 9, 1e-10);
+  fn.template operator()<double>(45, 16, 1e-10);
+  fn.template operator()<float>(128, 33, 1e-4);
+}
+
+// Batched transform against hilbert_fftw_r2c line by line, contiguous and
+// strided (leading dimension > n)
+TEST(TestHilbertFFTWBatch, MatchesPerLine) {
+  const auto fn = [&]<typename T>(size_t n, size_t lines, size_t ld,
+                                  T tolerance) {
+    std::vector<T> x(ld * lines);
+    for (size_t i = 0; i < x.size(); ++i) {
+      x[i] = static_cast<T>(std::sin(0.37 * i) + 0.25 * std::cos(2.1 * i));
+    }
+
+    AlignedVector<T> line(n);
+    AlignedVector<T> expect(n * lines);
+    for (size_t j = 0; j < lines; ++j) {
+      std::copy(x.begin() + j * ld, x.begin() + j * ld + n, line.begin());
+      hilbert_fftw_r2c<T>(line, std::span<T>(expect.data() + j * n, n));
+    }
+
+    std::vector<T> env(ld * lines);
+    hilbert_fftw_batch<T>(x.data(), ld, env.data(), ld, n, lines);
+
+    for (size_t j = 0; j < lines; ++j) {
+      ExpectArraysNear<T>(expect.data() + j * n, env.data() + j * ld, n,
+                          tolerance);
+    }
+  };
+
+  fn.template operator()<double>(32, 5, 32, 1e-10);
+  fn.template operator()<double>(15, 3, 18, 1e-10);
+  fn.template operator()<float>(32, 4, 32, 1e-5);
+  fn.template operator()<float>(20, 3, 23, 1e-5);
+}
+
+// Lines split across a pool against hilbert_fftw_r2c on the calling thread
+TEST(TestHilbertFFTWParallel, MatchesPerLine) {
+  const auto fn = [&]<typename T>(size_t n, size_t lines, size_t ld,
+                                  size_t threads, T tolerance) {
+    std::vector<T> x(ld * lines);
+    for (size_t i = 0; i < x.size(); ++i) {
+      x[i] = static_cast<T>(std::sin(0.37 * i) + 0.25 * std::cos(2.1 * i));
+    }
+
+    AlignedVector<T> line(n);
+    AlignedVector<T> expect(n * lines);
+    for (size_t j = 0; j < lines; ++j) {
+      std::copy(x.begin() + j * ld, x.begin() + j * ld + n, line.begin());
+      hilbert_fftw_r2c<T>(line, std::span<T>(expect.data() + j * n, n));
+    }
+
+    ThreadPool pool(threads);
+    hilbert_fftw_warmup<T>(pool, n);
+    std::vector<T> env(ld * lines);
+    hilbert_fftw_parallel<T>(pool, x.data(), ld, env.data(), ld, n, lines);
+
+    for (size_t j = 0; j < lines; ++j) {
+      ExpectArraysNear<T>(expect.data() + j * n, env.data() + j * ld, n,
+                          tolerance);
+    }
+  };
+
+  fn.template operator()<double>(32, 7, 32, 3, 1e-10);
+  fn.template operator()<double>(15, 2, 18, 4, 1e-10);
+  fn.template operator()<float>(20, 9, 23, 2, 1e-5);
+}
+
+// Fused log compression against envelope -> 20 log10 -> clamp -> round,
+// allowing one level for the fast log
+TEST(TestHilbertLog, MatchesReference) {
+  const auto fn = [&]<typename T>(size_t n, T reference, T dynamic_range) {
+    AlignedVector<T> x(n);
+    for (size_t i = 0; i < n; ++i) {
+      x[i] = static_cast<T>(3 * std::sin(0.37 * i) * std::exp(-0.01 * i) +
+                            0.25 * std::cos(2.1 * i));
+    }
+    x[n / 2] = 0;
+
+    AlignedVector<T> env(n);
+    hilbert_fftw_r2c<T>(x, env);
+
+    LogCompression<T> lc{.dynamic_range = dynamic_range,
+                         .reference = reference};
+    std::vector<uint8_t> out(n);
+    hilbert_fftw_log<T>(x, out, lc);
+
+    for (size_t i = 0; i < n; ++i) {
+      const double db = 20 * std::log10(static_cast<double>(env[i] / reference));
+      const double level =
+          std::clamp(255 * (db + dynamic_range) / dynamic_range, 0., 255.);
+      EXPECT_LE(std::abs(static_cast<int>(out[i]) -
+                         static_cast<int>(std::nearbyint(level))),
+                1)
+          << "at index " << i;
+    }
+  };
+
+  fn.template operator()<float>(64, 1, 60);
+  fn.template operator()<float>(45, 0.5, 40);
+  fn.template operator()<double>(64, 1, 60);
+  fn.template operator()<double>(45, 2, 80);
+}
+
+// With running_max the first line is normalized by its own max, later lines
+// by the largest envelope so far
+TEST(TestHilbertLog, RunningMax) {
+  const size_t n = 64;
+  AlignedVector<float> x(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = static_cast<float>(std::sin(0.37 * i));
+  }
+  AlignedVector<float> env(n);
+  hilbert_fftw_r2c<float>(x, env);
+  const float max_env = *std::max_element(env.begin(), env.end());
+
+  LogCompression<float> lc{.running_max = true};
+  std::vector<uint8_t> out(n);
+  hilbert_fftw_log<float>(x, out, lc);
+  EXPECT_GE(*std::max_element(out.begin(), out.end()), 254);
+  EXPECT_NEAR(lc.max_envelope, max_env, 1e-5);
+
+  // A line at half the amplitude is ~6 dB down from the running max
+  AlignedVector<float> half(n);
+  std::transform(x.begin(), x.end(), half.begin(),
+                 [](float v) { return v / 2; });
+  hilbert_fftw_log<float>(half, out, lc);
+  const int peak = *std::max_element(out.begin(), out.end());
+  EXPECT_NEAR(peak, 255 * (60 - 20 * std::log10(2.)) / 60, 1);
+  EXPECT_NEAR(lc.max_envelope, max_env, 1e-5);
+}
+
+// A silent line (or reference 0) has nothing to normalize by and shows as
+// black; with running_max the next non-silent line becomes the reference
+TEST(TestHilbertLog, SilentFirstLine) {
+  const size_t n = 64;
+  AlignedVector<float> zeros(n, 0.F);
+  std::vector<uint8_t> out(n, 1);
+
+  LogCompression<float> lc{.running_max = true};
+  hilbert_fftw_log<float>(zeros, out, lc);
+  EXPECT_TRUE(std::all_of(out.begin(), out.end(),
+                          [](uint8_t v) { return v == 0; }));
+  EXPECT_EQ(lc.max_envelope, 0.F);
+
+  AlignedVector<float> x(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = static_cast<float>(std::sin(0.37 * i));
+  }
+  hilbert_fftw_log<float>(x, out, lc);
+  EXPECT_GE(*std::max_element(out.begin(), out.end()), 254);
+  EXPECT_GT(lc.max_envelope, 0.F);
+
+  LogCompression<float> zero_ref{.reference = 0};
+  std::fill(out.begin(), out.end(), uint8_t{1});
+  hilbert_fftw_log<float>(x, out, zero_ref);
+  EXPECT_TRUE(std::all_of(out.begin(), out.end(),
+                          [](uint8_t v) { return v == 0; }));
+}
+
+// With a tiny reference, s = 0 (and any s below FLT_MIN) still shows as
+// black instead of going through the fast log2 to full scale
+TEST(TestHilbertLog, TinyReference) {
+  const auto fn = [&]<typename T>(T reference, T amplitude) {
+    const size_t n = 36; // vector body and scalar tail
+    AlignedVector<T> zeros(n, T{0});
+    std::vector<uint8_t> out(n, 1);
+
+    LogCompression<T> lc{.reference = reference};
+    hilbert_fftw_log<T>(zeros, out, lc);
+    EXPECT_TRUE(std::all_of(out.begin(), out.end(),
+                            [](uint8_t v) { return v == 0; }));
+
+    AlignedVector<T> x(n);
+    for (size_t i = 0; i < n; ++i) {
+      x[i] = static_cast<T>(amplitude * std::sin(0.37 * i));
+    }
+    hilbert_fftw_log<T>(x, out, lc);
+    EXPECT_EQ(*std::max_element(out.begin(), out.end()), 255);
+  };
+
+  fn.template operator()<float>(1e-20F, 1e-18F);
+  fn.template operator()<double>(1e-30, 1e-18);
+}
+
 TEST(TestHilbertFFTWSplit, Correct) {
   const auto fn = [&]<typename T>() {
     const std::array<T, 10> inp = {
@@ -537,6 +904,216 @@ TEST(TestHilbertFFTWSplit, Correct) {
   fn.template operator()<double>();
 }
 
+// Split half spectrum against the interleaved r2c path, even and odd n
+TEST(TestHilbertFFTWSplit, MatchesR2C) {
+  const auto fn = [&]<typename T>(size_t n, T tolerance) {
+    AlignedVector<T> x(n);
+    for (size_t i = 0; i < n; ++i) {
+      x[i] = static_cast<T>(std::sin(0.37 * i) + 0.25 * std::cos(2.1 * i));
+    }
+    AlignedVector<T> expect(n);
+    hilbert_fftw_r2c<T>(x, expect);
+    AlignedVector<T> env(n);
+    hilbert_fftw_split<T>(x, env);
+    ExpectArraysNear<T>(expect.data(), env.data(), n, tolerance);
+  };
+
+  fn.template operator()<double>(64, 1e-10);
+  fn.template operator()<double>(45, 1e-10);
+  fn.template operator()<float>(64, 1e-5);
+  fn.template operator()<float>(45, 1e-5);
+}
+
+// An engine type with its own planner flags gets separate engines and plans
+// for the same size, with the same results
+TEST(EngineFlags, PerEngineOverride) {
+  using Engine = fftw::EngineR2C1D<double>;
+  const size_t n = 24;
+  AlignedVector<double> x(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = std::sin(0.37 * i) + 0.25 * std::cos(2.1 * i);
+  }
+  AlignedVector<double> expect(n);
+  hilbert_fftw_r2c<double>(x, expect);
+  const Engine *inherited = &Engine::get(n);
+
+  fftw::engine_flags<Engine>() = FFTW_ESTIMATE;
+  EXPECT_EQ(fftw::flags_for<Engine>(), FFTW_ESTIMATE);
+  EXPECT_NE(&Engine::get(n), inherited);
+  AlignedVector<double> env(n);
+  hilbert_fftw_r2c<double>(x, env);
+  ExpectArraysNear<double>(expect.data(), env.data(), n, 1e-10);
+
+  fftw::engine_flags<Engine>() = fftw::INHERIT_FLAGS;
+  EXPECT_EQ(fftw::flags_for<Engine>(), fftw::planner_flags().load());
+  EXPECT_EQ(&Engine::get(n), inherited);
+}
+
+TEST(NextFastSize, SevenSmooth) {
+  EXPECT_EQ(fftw::next_fast_size(0), 1);
+  EXPECT_EQ(fftw::next_fast_size(1), 1);
+  EXPECT_EQ(fftw::next_fast_size(11), 12);
+  EXPECT_EQ(fftw::next_fast_size(13), 14);
+  EXPECT_EQ(fftw::next_fast_size(97), 98);
+  EXPECT_EQ(fftw::next_fast_size(1021), 1024);
+  EXPECT_EQ(fftw::next_fast_size(2039), 2048);
+  EXPECT_EQ(fftw::next_fast_size(4093), 4096);
+  EXPECT_EQ(fftw::next_fast_size(1250), 1250);
+}
+
+// Plan with FFTW_ESTIMATE while in scope. Exhaustive planning at prime
+// sizes and at the larger overlap-save sizes would take minutes.
+struct EstimatePlanning { // NOLINT(*-special-member-functions)
+  unsigned saved = fftw::planner_flags().exchange(FFTW_ESTIMATE);
+  ~EstimatePlanning() { fftw::planner_flags() = saved; }
+};
+
+// Tone-burst that fades to zero at both ends, where padding and circular
+// wrap-around agree
+template <typename T> AlignedVector<T> tone_burst(size_t n, double f) {
+  AlignedVector<T> x(n);
+  for (size_t i = 0; i < n; ++i) {
+    const double w = std::sin(std::numbers::pi * static_cast<double>(i) /
+                              static_cast<double>(n - 1));
+    x[i] = static_cast<T>(w * w * std::cos(2 * std::numbers::pi * f * i));
+  }
+  return x;
+}
+
+TEST(TestHilbertPadded, MatchesExact) {
+  const EstimatePlanning estimate;
+  const auto fn = [&]<typename T>(size_t n, T tolerance) {
+    const auto x = tone_burst<T>(n, 0.1);
+    AlignedVector<T> expect(n);
+    hilbert_fftw_r2c<T>(x, expect);
+    AlignedVector<T> env(n);
+    hilbert_fftw_padded<T>(x, env);
+    ExpectArraysNear<T>(expect.data(), env.data(), n, tolerance);
+  };
+
+  // Already a fast size: no padding, same transform
+  fn.template operator()<double>(64, 1e-10);
+  // Primes
+  fn.template operator()<double>(1009, 1e-3);
+  fn.template operator()<float>(2039, 1e-3);
+}
+
+// Overlap-save against direct "same" convolution with the FIR kernel (zero
+// padded), over several blocks and a partial last one
+TEST(TestHilbertOverlapSave, MatchesDirectFIR) {
+  const EstimatePlanning estimate;
+  const auto fn = [&]<typename T>(size_t n, size_t taps, size_t block,
+                                  T tolerance) {
+    AlignedVector<T> x(n);
+    for (size_t i = 0; i < n; ++i) {
+      x[i] = static_cast<T>(std::sin(0.37 * i) + 0.25 * std::cos(2.1 * i));
+    }
+    const auto kernel = hilbert_fir_kernel<T>(taps);
+    const auto half = static_cast<std::ptrdiff_t>(taps / 2);
+    AlignedVector<T> expect(n);
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(n); ++i) {
+      double h = 0;
+      for (std::ptrdiff_t k = -half; k <= half; ++k) {
+        const auto j = i - k;
+        if (j >= 0 && j < static_cast<std::ptrdiff_t>(n)) {
+          h += kernel[k + half] * static_cast<double>(x[j]);
+        }
+      }
+      expect[i] = static_cast<T>(std::hypot(static_cast<double>(x[i]), h));
+    }
+
+    const HilbertOverlapSave<T> overlap_save(taps, block);
+    AlignedVector<T> env(n);
+    overlap_save.envelope(x, env);
+    ExpectArraysNear<T>(expect.data(), env.data(), n, tolerance);
+  };
+
+  fn.template operator()<double>(1000, 31, 128, 1e-10);
+  fn.template operator()<double>(50, 31, 256, 1e-10);
+  fn.template operator()<float>(777, 63, 256, 1e-5);
+}
+
+// The FIR approximation against the exact transform, away from the ends
+TEST(TestHilbertOverlapSave, MatchesExactInBand) {
+  const EstimatePlanning estimate;
+  const size_t n = 4096;
+  const auto x = tone_burst<double>(n, 0.15);
+  AlignedVector<double> expect(n);
+  hilbert_fftw_r2c<double>(x, expect);
+  const HilbertOverlapSave<double> overlap_save(255, 1024);
+  AlignedVector<double> env(n);
+  overlap_save.envelope(x, env);
+  ExpectArraysNear<double>(expect.data() + 256, env.data() + 256, n - 512,
+                           1e-3);
+}
+
+struct CachedBytes {
+  size_t n;
+  explicit CachedBytes(size_t n) : n(n) {}
+  [[nodiscard]] auto bytes() const -> size_t { return n; }
+};
+
+TEST(LruCache, EvictsLeastRecentlyUsed) {
+  CacheLimits limits;
+  limits.max_entries = 3;
+  CacheCounters counters;
+  LruCache<size_t, CachedBytes> cache(limits, counters);
+
+  cache.get(1);
+  cache.get(2);
+  cache.get(3);
+  cache.get(1); // 2 is now the least recent
+  cache.get(4);
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_EQ(counters.hits, 1);
+  EXPECT_EQ(counters.misses, 4);
+  EXPECT_EQ(counters.evictions, 1);
+  EXPECT_EQ(cache.resident_bytes(), 3 * sizeof(CachedBytes) + 1 + 3 + 4);
+  EXPECT_EQ(counters.resident_bytes, cache.resident_bytes());
+
+  cache.get(2); // miss: evicts 3
+  EXPECT_EQ(counters.misses, 5);
+  cache.get(1);
+  cache.get(4);
+  EXPECT_EQ(counters.hits, 3);
+
+  // A byte limit below the newest entry still keeps that entry
+  limits.max_bytes = 100;
+  cache.get(1000);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(counters.evictions, 5);
+
+  cache.clear();
+  EXPECT_EQ(counters.resident_bytes, 0);
+}
+
+// Engines evicted from a full cache are rebuilt and still give the same
+// results
+TEST(LruCache, EngineEviction) {
+  const size_t max_entries = fftw::cache_limits().max_entries;
+  fftw::cache_limits().max_entries = 2;
+  const size_t evictions = fftw::cache_counters().evictions;
+
+  const auto envelope = [](size_t n) {
+    AlignedVector<double> x(n);
+    for (size_t i = 0; i < n; ++i) {
+      x[i] = std::sin(0.37 * i) + 0.25 * std::cos(2.1 * i);
+    }
+    AlignedVector<double> env(n);
+    hilbert_fftw_r2c<double>(x, env);
+    return env;
+  };
+  const auto expect = envelope(40);
+  envelope(41);
+  envelope(42);
+  envelope(43);
+  EXPECT_GE(fftw::cache_counters().evictions, evictions + 2);
+  const auto env = envelope(40);
+  ExpectArraysNear<double>(expect.data(), env.data(), expect.size(), 1e-12);
+
+  fftw::cache_limits().max_entries = max_entries;
+}
+
 // NOLINTEND(*-magic-numbers, *-pointer-arithmetic, *-non-private-member-*,
 // *-member-function, *-destructor)
 
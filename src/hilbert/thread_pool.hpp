@@ -0,0 +1,96 @@
+/**
+A fixed-size pool of long-lived worker threads.
+
+Workers live as long as the pool, so thread_local state built on a worker
+(e.g. the cached FFTW engines) is reused by every task it runs.
+ */
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class ThreadPool {
+public:
+  explicit ThreadPool(size_t n_threads) {
+    n_threads = std::max<size_t>(n_threads, 1);
+    workers.reserve(n_threads);
+    for (size_t w = 0; w < n_threads; ++w) {
+      workers.emplace_back([this, w] { loop(w); });
+    }
+  }
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool(ThreadPool &&) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ThreadPool &operator=(ThreadPool &&) = delete;
+  ~ThreadPool() {
+    {
+      const std::lock_guard lock(mtx);
+      stop = true;
+    }
+    cv_start.notify_all();
+    // Join before the mutex and condition variables go away
+    workers.clear();
+  }
+
+  [[nodiscard]] auto size() const -> size_t { return workers.size(); }
+
+  // Run fn(worker) once on every worker and wait for all of them
+  void run(const std::function<void(size_t)> &fn) {
+    std::unique_lock lock(mtx);
+    task = &fn;
+    pending = workers.size();
+    ++generation;
+    cv_start.notify_all();
+    cv_done.wait(lock, [this] { return pending == 0; });
+    task = nullptr;
+  }
+
+  // Split [0, count) into one contiguous chunk per worker and run
+  // fn(begin, end) on each
+  template <typename Func> void parallel_for(size_t count, Func &&fn) {
+    const size_t n = workers.size();
+    run([&](size_t w) {
+      const size_t begin = count * w / n;
+      const size_t end = count * (w + 1) / n;
+      if (begin < end) { fn(begin, end); }
+    });
+  }
+
+private:
+  std::vector<std::jthread> workers;
+  std::mutex mtx;
+  std::condition_variable cv_start;
+  std::condition_variable cv_done;
+  const std::function<void(size_t)> *task{};
+  size_t generation{};
+  size_t pending{};
+  bool stop{};
+
+  void loop(size_t w) {
+    size_t seen = 0;
+    while (true) {
+      const std::function<void(size_t)> *fn{};
+      {
+        std::unique_lock lock(mtx);
+        cv_start.wait(lock, [&] { return stop || generation != seen; });
+        if (stop) { return; }
+        seen = generation;
+        fn = task;
+      }
+
+      (*fn)(w);
+
+      {
+        const std::lock_guard lock(mtx);
+        --pending;
+      }
+      cv_done.notify_one();
+    }
+  }
+};